@@ -11,6 +11,22 @@ set_target_properties(${PROJECT} PROPERTIES
 target_include_directories(${PROJECT} PUBLIC "${DTROOT}/include")
 target_link_directories(${PROJECT} PUBLIC "${DTROOT}/build")
 
+# Headless builds never open a window, and compile the rendering components to no-ops. They only need
+# sfml-system, so they build without the window, OpenGL and audio dependencies, and without AudioSource.
+option(DUCKTAPE_HEADLESS "Build Ducktape for headless simulation, without rendering" OFF)
+if (DUCKTAPE_HEADLESS)
+    target_compile_definitions(${PROJECT} PUBLIC DT_HEADLESS)
+    set(BOX2D_BUILD_TESTBED OFF CACHE BOOL "" FORCE)
+    set(BOX2D_BUILD_UNIT_TESTS OFF CACHE BOOL "" FORCE)
+    set(SFML_BUILD_WINDOW FALSE CACHE BOOL "" FORCE)
+    set(SFML_BUILD_GRAPHICS FALSE CACHE BOOL "" FORCE)
+    set(SFML_BUILD_AUDIO FALSE CACHE BOOL "" FORCE)
+    set(SFML_BUILD_NETWORK FALSE CACHE BOOL "" FORCE)
+endif (DUCKTAPE_HEADLESS)
+
+# Threads
+find_package(Threads REQUIRED)
+
 # Box2D
 add_subdirectory(${DTROOT}/extern/box2d ${DTROOT}/build/extern/box2d/bin)
 target_include_directories(${PROJECT} PUBLIC "${DTROOT}/extern/box2d/include")
@@ -23,17 +39,27 @@ set(SFML_DIR ${DTROOT}/extern/SFML/cmake/)
 target_include_directories(${PROJECT} PUBLIC "${DTROOT}/extern/SFML/include")
 target_link_directories(${PROJECT} PUBLIC "${DTROOT}/build/extern/SFML/lib")
 
-target_link_libraries(${PROJECT} PRIVATE
-    ducktape
-    sfml-window
-    sfml-system
-    sfml-graphics
-    sfml-audio
-    sfml-system
-    sfml-network
-    glad
-    glfw
-    imgui
-    sajson
-    box2d
-)
\ No newline at end of file
+if (DUCKTAPE_HEADLESS)
+    target_link_libraries(${PROJECT} PRIVATE
+        ducktape
+        sfml-system
+        box2d
+        Threads::Threads
+    )
+else ()
+    target_link_libraries(${PROJECT} PRIVATE
+        ducktape
+        sfml-window
+        sfml-system
+        sfml-graphics
+        sfml-audio
+        sfml-system
+        sfml-network
+        glad
+        glfw
+        imgui
+        sajson
+        box2d
+        Threads::Threads
+    )
+endif (DUCKTAPE_HEADLESS)
\ No newline at end of file
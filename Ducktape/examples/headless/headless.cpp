@@ -0,0 +1,33 @@
+#include <Ducktape/ducktape.h>
+#include <cstdio>
+using namespace DT;
+
+class Falling : public Scene {
+public:
+    void Init()
+    {
+        Entity* ground = Entity::Instantiate("Ground", Vector2(0.f, 10.f), 0.f, Vector2(40.f, 1.f));
+        ground->AddComponent<Rigidbody2D>()->SetType(staticBody);
+        ground->AddComponent<BoxCollider2D>();
+
+        for (int i = 0; i < 100; i++)
+        {
+            Entity* box = Entity::Instantiate("Box", Vector2((i % 10) * 1.5f - 7.f, -(i / 10) * 1.5f), 0.f, Vector2(1.f, 1.f));
+            box->AddComponent<Rigidbody2D>();
+            box->AddComponent<BoxCollider2D>()->SetDensity(1.f);
+        }
+    }
+};
+
+int main()
+{
+    ProjectSettings::Application::headless = true;
+    ProjectSettings::Application::maxFrames = 600;
+    ProjectSettings::Physics::deterministic = true;
+    ProjectSettings::SceneManagement::initialScene = new Falling();
+
+    Init();
+
+    std::printf("Stepped %llu times, checksum %016llx\n", (unsigned long long)Physics::stepCount, (unsigned long long)Physics::stepChecksum);
+    return Physics::stepCount == 0 ? 1 : 0;
+}
\ No newline at end of file
@@ -257,6 +257,14 @@ public:
 	/// the mass and you later want to reset the mass.
 	void ResetMassData();
 
+	/// Call this after editing the shapes of this body's fixtures in place, through
+	/// b2Fixture::GetShape. This updates the broad-phase proxies of the fixtures and
+	/// resets the mass properties, so edits to several fixtures need a single call.
+	/// The child count of an edited shape must not change.
+	/// Note: contacts are updated on the next call to b2World::Step.
+	/// @warning This function is locked during callbacks.
+	void SynchronizeShapes();
+
 	/// Get the world coordinates of a point given the local coordinates.
 	/// @param localPoint a point on the body measured relative the the body's origin.
 	/// @return the same point expressed in world coordinates.
@@ -392,6 +400,7 @@ private:
 
 	friend class b2World;
 	friend class b2Island;
+	friend class b2IslandBatch;
 	friend class b2ContactManager;
 	friend class b2ContactSolver;
 	friend class b2Contact;
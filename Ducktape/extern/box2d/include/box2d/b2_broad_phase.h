@@ -56,6 +56,14 @@ public:
 	/// Destroy a proxy. It is up to the client to remove any pairs.
 	void DestroyProxy(int32 proxyId);
 
+	/// Hold the proxies created from now on out of the tree until EndBulkInsert, which inserts
+	/// them all at once with b2DynamicTree::InsertProxies. In between they aren't found by
+	/// queries, and no proxy can be moved or destroyed.
+	void BeginBulkInsert();
+
+	/// Insert the proxies created since BeginBulkInsert in the tree.
+	void EndBulkInsert();
+
 	/// Call MoveProxy as many times as you like, then when you are done
 	/// call UpdatePairs to finalized the proxy pairs (for your time step).
 	void MoveProxy(int32 proxyId, const b2AABB& aabb, const b2Vec2& displacement);
@@ -103,11 +111,20 @@ public:
 	/// Get the quality metric of the embedded tree.
 	float GetTreeQuality() const;
 
+	/// Rebuild the embedded tree top-down, see b2DynamicTree::RebuildTopDown.
+	void RebuildTree();
+
 	/// Shift the world origin. Useful for large worlds.
 	/// The shift formula is: position -= newOrigin
 	/// @param newOrigin the new origin with respect to the old origin
 	void ShiftOrigin(const b2Vec2& newOrigin);
 
+	/// Save the tree and the buffered moves, for b2World::SaveState.
+	void SaveState(b2WorldState* state) const;
+
+	/// Restore the tree and buffered moves saved by SaveState. Returns false if the state is truncated.
+	bool RestoreState(b2WorldStateReader* reader);
+
 private:
 
 	friend class b2DynamicTree;
@@ -125,6 +142,11 @@ private:
 	int32 m_moveCapacity;
 	int32 m_moveCount;
 
+	int32* m_bulkBuffer;
+	int32 m_bulkCapacity;
+	int32 m_bulkCount;
+	bool m_bulkInsert;
+
 	b2Pair* m_pairBuffer;
 	int32 m_pairCapacity;
 	int32 m_pairCount;
@@ -169,6 +191,11 @@ inline float b2BroadPhase::GetTreeQuality() const
 	return m_tree.GetAreaRatio();
 }
 
+inline void b2BroadPhase::RebuildTree()
+{
+	m_tree.RebuildTopDown();
+}
+
 template <typename T>
 void b2BroadPhase::UpdatePairs(T* callback)
 {
@@ -82,6 +82,10 @@
 /// Maximum number of contacts to be handled to solve a TOI impact.
 #define b2_maxTOIContacts			32
 
+/// Minimum number of contacts whose manifolds are computed by a single task, when the
+/// world has a task executor.
+#define b2_minParallelContacts		64
+
 /// The maximum linear position correction used when solving constraints. This helps to
 /// prevent overshoot. Meters.
 #define b2_maxLinearCorrection		(0.2f * b2_lengthUnitsPerMeter)
@@ -210,6 +210,13 @@ protected:
 
 	void Update(b2ContactListener* listener);
 
+	// Compute the new manifold and touching status without changing the contact, so
+	// several contacts can be computed in parallel.
+	bool ComputeManifold(b2Manifold* manifold);
+
+	// Store a manifold from ComputeManifold, waking the bodies and reporting to the listener.
+	void Update(b2ContactListener* listener, const b2Manifold& manifold, bool touching);
+
 	static b2ContactRegister s_registers[b2Shape::e_typeCount][b2Shape::e_typeCount];
 	static bool s_initialized;
 
@@ -234,6 +241,9 @@ protected:
 	int32 m_toiCount;
 	float m_toi;
 
+	// Where the manifold computed in parallel by b2ContactManager::Collide is, -1 if it wasn't.
+	int32 m_collideIndex;
+
 	float m_friction;
 	float m_restitution;
 	float m_restitutionThreshold;
@@ -30,28 +30,46 @@ class b2Contact;
 class b2ContactFilter;
 class b2ContactListener;
 class b2BlockAllocator;
+class b2TaskExecutor;
+struct b2Manifold;
 
 // Delegate of b2World.
 class B2_API b2ContactManager
 {
 public:
 	b2ContactManager();
+	~b2ContactManager();
 
 	// Broad-phase callback.
 	void AddPair(void* proxyUserDataA, void* proxyUserDataB);
 
 	void FindNewContacts();
 
+	// Link a new contact into the contact list of the world and of its bodies.
+	void Insert(b2Contact* c);
+
 	void Destroy(b2Contact* c);
 
 	void Collide();
 
+	// Compute the manifolds of the contacts that will be updated by Collide with the task
+	// executor. Returns false if there weren't enough of them to be worth it.
+	bool ComputeManifolds();
+	void ComputeManifolds(int32 begin, int32 end);
+
 	b2BroadPhase m_broadPhase;
 	b2Contact* m_contactList;
 	int32 m_contactCount;
 	b2ContactFilter* m_contactFilter;
 	b2ContactListener* m_contactListener;
 	b2BlockAllocator* m_allocator;
+	b2TaskExecutor* m_taskExecutor;
+
+	// Buffers for the manifolds computed in parallel, kept between steps.
+	b2Contact** m_collideContacts;
+	b2Manifold* m_collideManifolds;
+	bool* m_collideTouching;
+	int32 m_collideCapacity;
 };
 
 #endif
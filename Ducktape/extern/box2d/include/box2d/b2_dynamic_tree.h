@@ -29,6 +29,10 @@
 
 #define b2_nullNode (-1)
 
+class b2WorldState;
+class b2WorldStateReader;
+struct b2TreeBuildLeaf;
+
 /// A node in the dynamic tree. The client does not interact with this directly.
 struct B2_API b2TreeNode
 {
@@ -77,6 +81,15 @@ public:
 	/// Create a proxy. Provide a tight fitting AABB and a userData pointer.
 	int32 CreateProxy(const b2AABB& aabb, void* userData);
 
+	/// Create a proxy like CreateProxy, without inserting it in the tree. It isn't found by
+	/// queries until it is inserted with InsertProxies, and can't be moved or destroyed before.
+	int32 CreateDetachedProxy(const b2AABB& aabb, void* userData);
+
+	/// Insert proxies created with CreateDetachedProxy. They are built into a subtree top-down
+	/// with the surface area heuristic, and the subtree is inserted like a single leaf, so a batch
+	/// costs one insertion rather than one per proxy.
+	void InsertProxies(const int32* proxyIds, int32 count);
+
 	/// Destroy a proxy. This asserts if the id is invalid.
 	void DestroyProxy(int32 proxyId);
 
@@ -128,11 +141,22 @@ public:
 	/// Build an optimal tree. Very expensive. For testing.
 	void RebuildBottomUp();
 
+	/// Build a balanced tree top-down with the surface area heuristic, in O(n log n) time.
+	/// Proxies keep their ids. Use this after creating many proxies that won't move, such as
+	/// the static geometry of a level, which gives a poor tree when inserted one by one.
+	void RebuildTopDown();
+
 	/// Shift the world origin. Useful for large worlds.
 	/// The shift formula is: position -= newOrigin
 	/// @param newOrigin the new origin with respect to the old origin
 	void ShiftOrigin(const b2Vec2& newOrigin);
 
+	/// Save the nodes of the tree, including the free ones, for b2World::SaveState.
+	void SaveState(b2WorldState* state) const;
+
+	/// Restore the nodes saved by SaveState. Returns false if the state is truncated.
+	bool RestoreState(b2WorldStateReader* reader);
+
 private:
 
 	int32 AllocateNode();
@@ -143,6 +167,8 @@ private:
 
 	int32 Balance(int32 index);
 
+	int32 BuildTopDown(b2TreeBuildLeaf* leaves, int32 count, int32 depth);
+
 	int32 ComputeHeight() const;
 	int32 ComputeHeight(int32 nodeId) const;
 
@@ -0,0 +1,57 @@
+// MIT License
+
+// Copyright (c) 2019 Erin Catto
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef B2_TASK_H
+#define B2_TASK_H
+
+#include "b2_api.h"
+#include "b2_types.h"
+
+/// A range of independent work items that can be split between threads.
+class B2_API b2Task
+{
+public:
+	virtual ~b2Task() {}
+
+	/// Run the items in [begin, end).
+	/// @param threadIndex index of the thread running the items, in [0, b2TaskExecutor::GetThreadCount()).
+	/// Two ranges running at the same time never share a thread index.
+	virtual void Execute(int32 begin, int32 end, int32 threadIndex) = 0;
+};
+
+/// Implement this to let the world spread its work over your own thread pool.
+/// Without one, the world does all of its work on the thread calling b2World::Step.
+class B2_API b2TaskExecutor
+{
+public:
+	virtual ~b2TaskExecutor() {}
+
+	/// Get the number of threads that may run ranges at the same time, including
+	/// the thread calling b2World::Step.
+	virtual int32 GetThreadCount() const = 0;
+
+	/// Split [0, count) into ranges of at least minRange items and run them with task->Execute.
+	/// Only return once every range has finished.
+	virtual void ParallelFor(b2Task* task, int32 count, int32 minRange) = 0;
+};
+
+#endif
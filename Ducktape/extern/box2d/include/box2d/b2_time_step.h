@@ -25,6 +25,8 @@
 #include "b2_api.h"
 #include "b2_math.h"
 
+class b2Body;
+
 /// Profiling data. Times are in milliseconds.
 struct B2_API b2Profile
 {
@@ -63,12 +65,23 @@ struct B2_API b2Velocity
 	float w;
 };
 
+/// The index of a static body inside an island. Islands solved in parallel can share
+/// static bodies, so their indices are looked up here instead of stored on the body.
+/// This is an internal structure.
+struct B2_API b2StaticIndex
+{
+	const b2Body* body;
+	int32 index;
+};
+
 /// Solver Data
 struct B2_API b2SolverData
 {
 	b2TimeStep step;
 	b2Position* positions;
 	b2Velocity* velocities;
+	const b2StaticIndex* statics;
+	int32 staticCount;
 };
 
 #endif
@@ -28,6 +28,7 @@
 #include "b2_contact_manager.h"
 #include "b2_math.h"
 #include "b2_stack_allocator.h"
+#include "b2_task.h"
 #include "b2_time_step.h"
 #include "b2_world_callbacks.h"
 
@@ -38,7 +39,9 @@ struct b2JointDef;
 class b2Body;
 class b2Draw;
 class b2Fixture;
+class b2IslandBatch;
 class b2Joint;
+class b2WorldState;
 
 /// The world class manages all physics entities, dynamic simulation,
 /// and asynchronous queries. The world also contains efficient memory
@@ -71,6 +74,16 @@ public:
 	/// by you and must remain in scope.
 	void SetDebugDraw(b2Draw* debugDraw);
 
+	/// Register a task executor to compute contact manifolds and solve separate islands on
+	/// several threads. The executor is owned by you and must remain in scope. Pass nullptr
+	/// to do everything on the calling thread. The result doesn't depend on the number of
+	/// threads, and every b2ContactListener callback is still made on the calling thread,
+	/// in the same order as without an executor.
+	void SetTaskExecutor(b2TaskExecutor* executor);
+
+	/// Get the registered task executor, if any.
+	b2TaskExecutor* GetTaskExecutor() const;
+
 	/// Create a rigid body given a definition. No reference to the definition
 	/// is retained.
 	/// @warning This function is locked during callbacks.
@@ -184,6 +197,20 @@ public:
 	/// The minimum is 1.
 	float GetTreeQuality() const;
 
+	/// Rebuild the dynamic tree top-down with the surface area heuristic. Call this after
+	/// creating a lot of static geometry at once, such as when loading a level, to speed up
+	/// the broad-phase and queries. Proxies are inserted one by one as fixtures are created,
+	/// which builds a worse tree than one that sees all of them.
+	/// @warning this should be called outside of a time step.
+	void RebuildTree();
+
+	/// Enable many disabled bodies at once, such as the bodies of a level created disabled while
+	/// their fixtures were added. Their proxies are built into one subtree of the broad-phase tree
+	/// with the surface area heuristic, and the subtree is inserted with a single tree insertion
+	/// instead of one per proxy. Bodies that are already enabled are skipped.
+	/// @warning this should be called outside of a time step.
+	void EnableBodies(b2Body* const* bodies, int32 count);
+
 	/// Change the global gravity vector.
 	void SetGravity(const b2Vec2& gravity);
 
@@ -214,6 +241,20 @@ public:
 	/// @warning this should be called outside of a time step.
 	void Dump();
 
+	/// Save the simulation state of the world, to roll it back later with RestoreState.
+	/// Unlike Dump, this is fast enough to call every step, and also saves the contacts and
+	/// the broad-phase, so the restored world steps exactly like the saved one did.
+	/// @warning this should be called outside of a time step.
+	void SaveState(b2WorldState* state);
+
+	/// Restore a state saved by SaveState. The world must still have the bodies, fixtures and
+	/// joints it had when the state was saved, their parameters are restored along with their
+	/// motion. The current contacts are replaced by the saved ones without calling the
+	/// contact listener.
+	/// @warning this should be called outside of a time step.
+	/// @return false, leaving the world untouched, if the state doesn't match the world.
+	bool RestoreState(const b2WorldState* state);
+
 private:
 
 	friend class b2Body;
@@ -222,10 +263,16 @@ private:
 	friend class b2Controller;
 
 	void Solve(const b2TimeStep& step);
+	void SolveParallel(const b2TimeStep& step);
 	void SolveTOI(const b2TimeStep& step);
 
+	template <typename T>
+	void AddIsland(b2Body* seed, b2Body** stack, int32 stackSize, T* island);
+
 	void DrawShape(b2Fixture* shape, const b2Transform& xf, const b2Color& color);
 
+	uint32 ComputeStructureHash() const;
+
 	b2BlockAllocator m_blockAllocator;
 	b2StackAllocator m_stackAllocator;
 
@@ -243,6 +290,9 @@ private:
 	b2DestructionListener* m_destructionListener;
 	b2Draw* m_debugDraw;
 
+	b2TaskExecutor* m_taskExecutor;
+	b2IslandBatch* m_islandBatch;
+
 	// This is used to compute the time step ratio to
 	// support a variable time step.
 	float m_inv_dt0;
@@ -337,6 +387,11 @@ inline const b2ContactManager& b2World::GetContactManager() const
 	return m_contactManager;
 }
 
+inline b2TaskExecutor* b2World::GetTaskExecutor() const
+{
+	return m_taskExecutor;
+}
+
 inline const b2Profile& b2World::GetProfile() const
 {
 	return m_profile;
@@ -0,0 +1,117 @@
+// MIT License
+
+// Copyright (c) 2019 Erin Catto
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef B2_WORLD_STATE_H
+#define B2_WORLD_STATE_H
+
+#include "b2_api.h"
+#include "b2_settings.h"
+
+#include <string.h>
+
+/// A compact binary copy of the simulation state of a world, to roll it back and resimulate.
+/// It holds the state of every body, fixture, joint and contact, including the broad-phase
+/// tree and the contact impulses used for warm starting, so a restored world steps exactly
+/// like the saved one did. The bodies, fixtures and joints themselves aren't saved: a state can
+/// only be restored into the world it was saved from, while it still has the same ones.
+/// The buffer is kept between saves, so saving into the same state every step doesn't allocate.
+/// @see b2World::SaveState
+class B2_API b2WorldState
+{
+public:
+	b2WorldState();
+	~b2WorldState();
+
+	b2WorldState(const b2WorldState& other);
+	b2WorldState& operator=(const b2WorldState& other);
+
+	/// Get the saved data.
+	const void* GetData() const { return m_data; }
+
+	/// Get the size of the saved data in bytes.
+	int32 GetSize() const { return m_size; }
+
+	/// Drop the saved data, keeping the buffer.
+	void Clear() { m_size = 0; }
+
+	/// Append bytes to the saved data.
+	void Write(const void* data, int32 size)
+	{
+		memcpy(Extend(size), data, size);
+	}
+
+	/// Append a value to the saved data.
+	template <typename T>
+	void Write(const T& value)
+	{
+		Write(&value, sizeof(T));
+	}
+
+	/// Reserve bytes at the end of the saved data, to be filled by the caller.
+	void* Extend(int32 size)
+	{
+		if (m_size + size > m_capacity)
+		{
+			Grow(m_size + size);
+		}
+
+		void* start = m_data + m_size;
+		m_size += size;
+		return start;
+	}
+
+private:
+
+	void Grow(int32 capacity);
+
+	char* m_data;
+	int32 m_size;
+	int32 m_capacity;
+};
+
+/// Reads the data of a b2WorldState back, in the order it was written.
+class B2_API b2WorldStateReader
+{
+public:
+	explicit b2WorldStateReader(const b2WorldState* state);
+
+	/// Copy the next bytes out. Returns false, and copies nothing, if there aren't enough left.
+	bool Read(void* data, int32 size);
+
+	/// Read the next value.
+	template <typename T>
+	bool Read(T* value)
+	{
+		return Read(value, sizeof(T));
+	}
+
+	/// Get the number of bytes that haven't been read yet.
+	int32 GetRemaining() const { return m_size - m_offset; }
+
+private:
+
+	const char* m_data;
+	int32 m_size;
+	int32 m_offset;
+};
+
+#endif
@@ -40,9 +40,11 @@
 #include "b2_body.h"
 #include "b2_contact.h"
 #include "b2_fixture.h"
+#include "b2_task.h"
 #include "b2_time_step.h"
 #include "b2_world.h"
 #include "b2_world_callbacks.h"
+#include "b2_world_state.h"
 
 #include "b2_distance_joint.h"
 #include "b2_friction_joint.h"
@@ -21,6 +21,7 @@
 // SOFTWARE.
 
 #include "box2d/b2_broad_phase.h"
+#include "box2d/b2_world_state.h"
 #include <string.h>
 
 b2BroadPhase::b2BroadPhase()
@@ -34,24 +35,65 @@ b2BroadPhase::b2BroadPhase()
 	m_moveCapacity = 16;
 	m_moveCount = 0;
 	m_moveBuffer = (int32*)b2Alloc(m_moveCapacity * sizeof(int32));
+
+	m_bulkCapacity = 16;
+	m_bulkCount = 0;
+	m_bulkBuffer = (int32*)b2Alloc(m_bulkCapacity * sizeof(int32));
+	m_bulkInsert = false;
 }
 
 b2BroadPhase::~b2BroadPhase()
 {
+	b2Free(m_bulkBuffer);
 	b2Free(m_moveBuffer);
 	b2Free(m_pairBuffer);
 }
 
 int32 b2BroadPhase::CreateProxy(const b2AABB& aabb, void* userData)
 {
-	int32 proxyId = m_tree.CreateProxy(aabb, userData);
+	if (m_bulkInsert == false)
+	{
+		int32 proxyId = m_tree.CreateProxy(aabb, userData);
+		++m_proxyCount;
+		BufferMove(proxyId);
+		return proxyId;
+	}
+
+	int32 proxyId = m_tree.CreateDetachedProxy(aabb, userData);
 	++m_proxyCount;
 	BufferMove(proxyId);
+
+	if (m_bulkCount == m_bulkCapacity)
+	{
+		int32* oldBuffer = m_bulkBuffer;
+		m_bulkCapacity *= 2;
+		m_bulkBuffer = (int32*)b2Alloc(m_bulkCapacity * sizeof(int32));
+		memcpy(m_bulkBuffer, oldBuffer, m_bulkCount * sizeof(int32));
+		b2Free(oldBuffer);
+	}
+
+	m_bulkBuffer[m_bulkCount] = proxyId;
+	++m_bulkCount;
 	return proxyId;
 }
 
+void b2BroadPhase::BeginBulkInsert()
+{
+	b2Assert(m_bulkInsert == false);
+	m_bulkInsert = true;
+}
+
+void b2BroadPhase::EndBulkInsert()
+{
+	b2Assert(m_bulkInsert);
+	m_tree.InsertProxies(m_bulkBuffer, m_bulkCount);
+	m_bulkCount = 0;
+	m_bulkInsert = false;
+}
+
 void b2BroadPhase::DestroyProxy(int32 proxyId)
 {
+	b2Assert(m_bulkInsert == false);
 	UnBufferMove(proxyId);
 	--m_proxyCount;
 	m_tree.DestroyProxy(proxyId);
@@ -59,6 +101,7 @@ void b2BroadPhase::DestroyProxy(int32 proxyId)
 
 void b2BroadPhase::MoveProxy(int32 proxyId, const b2AABB& aabb, const b2Vec2& displacement)
 {
+	b2Assert(m_bulkInsert == false);
 	bool buffer = m_tree.MoveProxy(proxyId, aabb, displacement);
 	if (buffer)
 	{
@@ -129,3 +172,33 @@ bool b2BroadPhase::QueryCallback(int32 proxyId)
 
 	return true;
 }
+
+void b2BroadPhase::SaveState(b2WorldState* state) const
+{
+	m_tree.SaveState(state);
+	state->Write(m_proxyCount);
+	state->Write(m_moveCount);
+	state->Write(m_moveBuffer, m_moveCount * sizeof(int32));
+}
+
+bool b2BroadPhase::RestoreState(b2WorldStateReader* reader)
+{
+	int32 proxyCount, moveCount;
+	if (!m_tree.RestoreState(reader) || !reader->Read(&proxyCount) || !reader->Read(&moveCount) ||
+		moveCount < 0 || reader->GetRemaining() < moveCount * (int32)sizeof(int32))
+	{
+		return false;
+	}
+
+	if (moveCount > m_moveCapacity)
+	{
+		b2Free(m_moveBuffer);
+		m_moveCapacity = moveCount;
+		m_moveBuffer = (int32*)b2Alloc(m_moveCapacity * sizeof(int32));
+	}
+
+	reader->Read(m_moveBuffer, moveCount * sizeof(int32));
+	m_proxyCount = proxyCount;
+	m_moveCount = moveCount;
+	return true;
+}
@@ -20,8 +20,19 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 #include "box2d/b2_dynamic_tree.h"
+#include "box2d/b2_world_state.h"
 #include <string.h>
 
+#include <algorithm>
+
+// A leaf copied out of the node pool for building, so the partitions touch contiguous memory.
+struct b2TreeBuildLeaf
+{
+	b2AABB aabb;
+	b2Vec2 center;
+	int32 id;
+};
+
 b2DynamicTree::b2DynamicTree()
 {
 	m_root = b2_nullNode;
@@ -105,6 +116,13 @@ void b2DynamicTree::FreeNode(int32 nodeId)
 // of the node instead of a pointer so that we can grow
 // the node pool.
 int32 b2DynamicTree::CreateProxy(const b2AABB& aabb, void* userData)
+{
+	int32 proxyId = CreateDetachedProxy(aabb, userData);
+	InsertLeaf(proxyId);
+	return proxyId;
+}
+
+int32 b2DynamicTree::CreateDetachedProxy(const b2AABB& aabb, void* userData)
 {
 	int32 proxyId = AllocateNode();
 
@@ -116,11 +134,33 @@ int32 b2DynamicTree::CreateProxy(const b2AABB& aabb, void* userData)
 	m_nodes[proxyId].height = 0;
 	m_nodes[proxyId].moved = true;
 
-	InsertLeaf(proxyId);
-
 	return proxyId;
 }
 
+void b2DynamicTree::InsertProxies(const int32* proxyIds, int32 count)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	b2TreeBuildLeaf* leaves = (b2TreeBuildLeaf*)b2Alloc(count * sizeof(b2TreeBuildLeaf));
+	for (int32 i = 0; i < count; ++i)
+	{
+		b2Assert(0 <= proxyIds[i] && proxyIds[i] < m_nodeCapacity);
+		b2Assert(m_nodes[proxyIds[i]].IsLeaf());
+		leaves[i].aabb = m_nodes[proxyIds[i]].aabb;
+		leaves[i].center = m_nodes[proxyIds[i]].aabb.GetCenter();
+		leaves[i].id = proxyIds[i];
+	}
+
+	int32 subtree = BuildTopDown(leaves, count, 0);
+	m_nodes[subtree].parent = b2_nullNode;
+	b2Free(leaves);
+
+	InsertLeaf(subtree);
+}
+
 void b2DynamicTree::DestroyProxy(int32 proxyId)
 {
 	b2Assert(0 <= proxyId && proxyId < m_nodeCapacity);
@@ -790,6 +830,199 @@ void b2DynamicTree::RebuildBottomUp()
 	Validate();
 }
 
+void b2DynamicTree::RebuildTopDown()
+{
+	b2TreeBuildLeaf* leaves = (b2TreeBuildLeaf*)b2Alloc(m_nodeCount * sizeof(b2TreeBuildLeaf));
+	int32 count = 0;
+
+	// Build array of leaves. Free the rest.
+	for (int32 i = 0; i < m_nodeCapacity; ++i)
+	{
+		if (m_nodes[i].height < 0)
+		{
+			// free node in pool
+			continue;
+		}
+
+		if (m_nodes[i].IsLeaf())
+		{
+			leaves[count].aabb = m_nodes[i].aabb;
+			leaves[count].center = m_nodes[i].aabb.GetCenter();
+			leaves[count].id = i;
+			++count;
+		}
+		else
+		{
+			FreeNode(i);
+		}
+	}
+
+	if (count == 0)
+	{
+		b2Free(leaves);
+		return;
+	}
+
+	m_root = BuildTopDown(leaves, count, 0);
+	m_nodes[m_root].parent = b2_nullNode;
+	b2Free(leaves);
+
+	Validate();
+}
+
+// The number of bins the centroids are sorted into to evaluate the split planes.
+static const int32 b2_treeBinCount = 16;
+
+// Past this depth nodes are split at the median, which bounds the height of the tree for
+// distributions the surface area heuristic splits badly.
+static const int32 b2_treeMaxSAHDepth = 48;
+
+int32 b2DynamicTree::BuildTopDown(b2TreeBuildLeaf* leaves, int32 count, int32 depth)
+{
+	if (count == 1)
+	{
+		return leaves[0].id;
+	}
+
+	// Split along the axis the centroids are most spread on.
+	b2Vec2 lower = leaves[0].center;
+	b2Vec2 upper = lower;
+	for (int32 i = 1; i < count; ++i)
+	{
+		lower = b2Min(lower, leaves[i].center);
+		upper = b2Max(upper, leaves[i].center);
+	}
+
+	int32 axis = upper.x - lower.x >= upper.y - lower.y ? 0 : 1;
+	float minCentroid = lower(axis);
+	float extent = upper(axis) - minCentroid;
+
+	int32 split = 0;
+	if (extent > 0.0f && depth < b2_treeMaxSAHDepth)
+	{
+		// Bin the leaves by centroid, then pick the plane between two bins that minimizes the
+		// summed perimeter of both sides weighted by their number of leaves.
+		b2AABB binAABBs[b2_treeBinCount];
+		int32 binCounts[b2_treeBinCount] = {};
+		float scale = b2_treeBinCount / extent;
+
+		for (int32 i = 0; i < count; ++i)
+		{
+			const b2AABB& aabb = leaves[i].aabb;
+			int32 bin = b2Min(int32((leaves[i].center(axis) - minCentroid) * scale), b2_treeBinCount - 1);
+			if (binCounts[bin] == 0)
+			{
+				binAABBs[bin] = aabb;
+			}
+			else
+			{
+				binAABBs[bin].Combine(aabb);
+			}
+			++binCounts[bin];
+		}
+
+		// Sweep from the right to get the cost of every right side.
+		float rightCosts[b2_treeBinCount];
+		b2AABB right;
+		int32 rightCount = 0;
+		for (int32 bin = b2_treeBinCount - 1; bin > 0; --bin)
+		{
+			if (binCounts[bin] > 0)
+			{
+				if (rightCount == 0)
+				{
+					right = binAABBs[bin];
+				}
+				else
+				{
+					right.Combine(binAABBs[bin]);
+				}
+				rightCount += binCounts[bin];
+			}
+			rightCosts[bin] = rightCount > 0 ? right.GetPerimeter() * rightCount : 0.0f;
+		}
+
+		// Sweep from the left, the plane is between bin - 1 and bin.
+		float bestCost = b2_maxFloat;
+		int32 bestBin = 0;
+		b2AABB left;
+		int32 leftCount = 0;
+		for (int32 bin = 1; bin < b2_treeBinCount; ++bin)
+		{
+			if (binCounts[bin - 1] > 0)
+			{
+				if (leftCount == 0)
+				{
+					left = binAABBs[bin - 1];
+				}
+				else
+				{
+					left.Combine(binAABBs[bin - 1]);
+				}
+				leftCount += binCounts[bin - 1];
+			}
+
+			if (leftCount == 0 || leftCount == count)
+			{
+				continue;
+			}
+
+			float cost = left.GetPerimeter() * leftCount + rightCosts[bin];
+			if (cost < bestCost)
+			{
+				bestCost = cost;
+				bestBin = bin;
+			}
+		}
+
+		if (bestBin > 0)
+		{
+			// Partition the leaves in place, those left of the plane first.
+			int32 i = 0;
+			int32 j = count - 1;
+			while (i <= j)
+			{
+				float c = leaves[i].center(axis);
+				if (b2Min(int32((c - minCentroid) * scale), b2_treeBinCount - 1) < bestBin)
+				{
+					++i;
+				}
+				else
+				{
+					b2Swap(leaves[i], leaves[j]);
+					--j;
+				}
+			}
+			split = i;
+		}
+	}
+
+	if (split == 0 || split == count)
+	{
+		// Split at the median centroid.
+		split = count / 2;
+		std::nth_element(leaves, leaves + split, leaves + count, [axis](const b2TreeBuildLeaf& a, const b2TreeBuildLeaf& b)
+		{
+			return a.center(axis) < b.center(axis);
+		});
+	}
+
+	int32 child1 = BuildTopDown(leaves, split, depth + 1);
+	int32 child2 = BuildTopDown(leaves + split, count - split, depth + 1);
+
+	// When rebuilding the whole tree the internal nodes were freed first, so this doesn't grow the pool.
+	int32 parentIndex = AllocateNode();
+	b2TreeNode* parent = m_nodes + parentIndex;
+	parent->child1 = child1;
+	parent->child2 = child2;
+	parent->height = 1 + b2Max(m_nodes[child1].height, m_nodes[child2].height);
+	parent->aabb.Combine(m_nodes[child1].aabb, m_nodes[child2].aabb);
+
+	m_nodes[child1].parent = parentIndex;
+	m_nodes[child2].parent = parentIndex;
+	return parentIndex;
+}
+
 void b2DynamicTree::ShiftOrigin(const b2Vec2& newOrigin)
 {
 	// Build array of leaves. Free the rest.
@@ -799,3 +1032,40 @@ void b2DynamicTree::ShiftOrigin(const b2Vec2& newOrigin)
 		m_nodes[i].aabb.upperBound -= newOrigin;
 	}
 }
+
+void b2DynamicTree::SaveState(b2WorldState* state) const
+{
+	state->Write(m_root);
+	state->Write(m_nodeCount);
+	state->Write(m_nodeCapacity);
+	state->Write(m_freeList);
+	state->Write(m_insertionCount);
+	state->Write(m_nodes, m_nodeCapacity * sizeof(b2TreeNode));
+}
+
+bool b2DynamicTree::RestoreState(b2WorldStateReader* reader)
+{
+	int32 root, nodeCount, nodeCapacity, freeList, insertionCount;
+	if (!reader->Read(&root) || !reader->Read(&nodeCount) || !reader->Read(&nodeCapacity) ||
+		!reader->Read(&freeList) || !reader->Read(&insertionCount) ||
+		nodeCapacity <= 0 || reader->GetRemaining() < nodeCapacity * (int32)sizeof(b2TreeNode))
+	{
+		return false;
+	}
+
+	// The allocation scheme relies on the free list running out exactly when the pool is full,
+	// so the pool must have the saved capacity, not just enough room.
+	if (nodeCapacity != m_nodeCapacity)
+	{
+		b2Free(m_nodes);
+		m_nodes = (b2TreeNode*)b2Alloc(nodeCapacity * sizeof(b2TreeNode));
+		m_nodeCapacity = nodeCapacity;
+	}
+
+	reader->Read(m_nodes, nodeCapacity * sizeof(b2TreeNode));
+	m_root = root;
+	m_nodeCount = nodeCount;
+	m_freeList = freeList;
+	m_insertionCount = insertionCount;
+	return true;
+}
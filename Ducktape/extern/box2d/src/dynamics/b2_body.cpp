@@ -439,6 +439,29 @@ void b2Body::SetTransform(const b2Vec2& position, float angle)
 	m_world->m_newContacts = true;
 }
 
+void b2Body::SynchronizeShapes()
+{
+	b2Assert(m_world->IsLocked() == false);
+	if (m_world->IsLocked() == true)
+	{
+		return;
+	}
+
+	if (m_flags & e_enabledFlag)
+	{
+		b2BroadPhase* broadPhase = &m_world->m_contactManager.m_broadPhase;
+		for (b2Fixture* f = m_fixtureList; f; f = f->m_next)
+		{
+			f->Synchronize(broadPhase, m_xf, m_xf);
+		}
+
+		// Check for new contacts the next step
+		m_world->m_newContacts = true;
+	}
+
+	ResetMassData();
+}
+
 void b2Body::SynchronizeFixtures()
 {
 	b2BroadPhase* broadPhase = &m_world->m_contactManager.m_broadPhase;
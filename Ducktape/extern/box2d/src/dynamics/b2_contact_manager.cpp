@@ -24,6 +24,7 @@
 #include "box2d/b2_contact.h"
 #include "box2d/b2_contact_manager.h"
 #include "box2d/b2_fixture.h"
+#include "box2d/b2_task.h"
 #include "box2d/b2_world_callbacks.h"
 
 b2ContactFilter b2_defaultFilter;
@@ -36,6 +37,19 @@ b2ContactManager::b2ContactManager()
 	m_contactFilter = &b2_defaultFilter;
 	m_contactListener = &b2_defaultListener;
 	m_allocator = nullptr;
+	m_taskExecutor = nullptr;
+
+	m_collideContacts = nullptr;
+	m_collideManifolds = nullptr;
+	m_collideTouching = nullptr;
+	m_collideCapacity = 0;
+}
+
+b2ContactManager::~b2ContactManager()
+{
+	b2Free(m_collideContacts);
+	b2Free(m_collideManifolds);
+	b2Free(m_collideTouching);
 }
 
 void b2ContactManager::Destroy(b2Contact* c)
@@ -106,8 +120,112 @@ void b2ContactManager::Destroy(b2Contact* c)
 // This is the top level collision call for the time step. Here
 // all the narrow phase collision is processed for the world
 // contact list.
+namespace
+{
+	class b2ComputeManifoldsTask : public b2Task
+	{
+	public:
+		explicit b2ComputeManifoldsTask(b2ContactManager* manager) : m_manager(manager) {}
+
+		void Execute(int32 begin, int32 end, int32 threadIndex) override
+		{
+			B2_NOT_USED(threadIndex);
+			m_manager->ComputeManifolds(begin, end);
+		}
+
+	private:
+		b2ContactManager* m_manager;
+	};
+}
+
+void b2ContactManager::ComputeManifolds(int32 begin, int32 end)
+{
+	for (int32 i = begin; i < end; ++i)
+	{
+		m_collideTouching[i] = m_collideContacts[i]->ComputeManifold(m_collideManifolds + i);
+	}
+}
+
+bool b2ContactManager::ComputeManifolds()
+{
+	// Find the contacts Collide will update: the ones that are neither filtered out, asleep,
+	// nor no longer overlapping. None of that changes while Collide runs, and neither do the
+	// transforms the manifolds are computed from.
+	int32 count = 0;
+	for (b2Contact* c = m_contactList; c; c = c->GetNext())
+	{
+		c->m_collideIndex = -1;
+
+		if (c->m_flags & b2Contact::e_filterFlag)
+		{
+			continue;
+		}
+
+		b2Fixture* fixtureA = c->GetFixtureA();
+		b2Fixture* fixtureB = c->GetFixtureB();
+		b2Body* bodyA = fixtureA->GetBody();
+		b2Body* bodyB = fixtureB->GetBody();
+
+		bool activeA = bodyA->IsAwake() && bodyA->m_type != b2_staticBody;
+		bool activeB = bodyB->IsAwake() && bodyB->m_type != b2_staticBody;
+		if (activeA == false && activeB == false)
+		{
+			continue;
+		}
+
+		int32 proxyIdA = fixtureA->m_proxies[c->GetChildIndexA()].proxyId;
+		int32 proxyIdB = fixtureB->m_proxies[c->GetChildIndexB()].proxyId;
+		if (m_broadPhase.TestOverlap(proxyIdA, proxyIdB) == false)
+		{
+			continue;
+		}
+
+		if (count == m_collideCapacity)
+		{
+			int32 capacity = b2Max(2 * m_collideCapacity, 256);
+
+			b2Contact** contacts = (b2Contact**)b2Alloc(capacity * sizeof(b2Contact*));
+			memcpy(contacts, m_collideContacts, count * sizeof(b2Contact*));
+			b2Free(m_collideContacts);
+			m_collideContacts = contacts;
+
+			b2Free(m_collideManifolds);
+			b2Free(m_collideTouching);
+			m_collideManifolds = (b2Manifold*)b2Alloc(capacity * sizeof(b2Manifold));
+			m_collideTouching = (bool*)b2Alloc(capacity * sizeof(bool));
+
+			m_collideCapacity = capacity;
+		}
+
+		c->m_collideIndex = count;
+		m_collideContacts[count++] = c;
+	}
+
+	if (count < b2_minParallelContacts)
+	{
+		for (int32 i = 0; i < count; ++i)
+		{
+			m_collideContacts[i]->m_collideIndex = -1;
+		}
+		return false;
+	}
+
+	b2ComputeManifoldsTask task(this);
+	m_taskExecutor->ParallelFor(&task, count, b2_minParallelContacts);
+	return true;
+}
+
 void b2ContactManager::Collide()
 {
+	// Compute the manifolds up front in parallel. Everything else, including waking bodies
+	// and reporting to the listener, still happens below in contact list order, so the
+	// result is the same as without a task executor.
+	bool computed = false;
+	if (m_taskExecutor != nullptr && m_taskExecutor->GetThreadCount() > 1)
+	{
+		computed = ComputeManifolds();
+	}
+
 	// Update awake contacts.
 	b2Contact* c = m_contactList;
 	while (c)
@@ -168,7 +286,15 @@ void b2ContactManager::Collide()
 		}
 
 		// The contact persists.
-		c->Update(m_contactListener);
+		// Contacts that were filtered or woken up since weren't computed up front.
+		if (computed && c->m_collideIndex >= 0)
+		{
+			c->Update(m_contactListener, m_collideManifolds[c->m_collideIndex], m_collideTouching[c->m_collideIndex]);
+		}
+		else
+		{
+			c->Update(m_contactListener);
+		}
 		c = c->GetNext();
 	}
 }
@@ -246,13 +372,14 @@ void b2ContactManager::AddPair(void* proxyUserDataA, void* proxyUserDataB)
 		return;
 	}
 
+	Insert(c);
+}
+
+void b2ContactManager::Insert(b2Contact* c)
+{
 	// Contact creation may swap fixtures.
-	fixtureA = c->GetFixtureA();
-	fixtureB = c->GetFixtureB();
-	indexA = c->GetChildIndexA();
-	indexB = c->GetChildIndexB();
-	bodyA = fixtureA->GetBody();
-	bodyB = fixtureB->GetBody();
+	b2Body* bodyA = c->GetFixtureA()->GetBody();
+	b2Body* bodyB = c->GetFixtureB()->GetBody();
 
 	// Insert into the world.
 	c->m_prev = nullptr;
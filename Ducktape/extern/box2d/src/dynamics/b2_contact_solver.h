@@ -69,6 +69,8 @@ struct b2ContactSolverDef
 	b2Position* positions;
 	b2Velocity* velocities;
 	b2StackAllocator* allocator;
+	const b2StaticIndex* statics;
+	int32 staticCount;
 };
 
 class b2ContactSolver
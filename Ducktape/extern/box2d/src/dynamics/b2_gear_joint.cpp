@@ -20,6 +20,8 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include "b2_island.h"
+
 #include "box2d/b2_gear_joint.h"
 #include "box2d/b2_revolute_joint.h"
 #include "box2d/b2_prismatic_joint.h"
@@ -140,10 +142,10 @@ b2GearJoint::b2GearJoint(const b2GearJointDef* def)
 
 void b2GearJoint::InitVelocityConstraints(const b2SolverData& data)
 {
-	m_indexA = m_bodyA->m_islandIndex;
-	m_indexB = m_bodyB->m_islandIndex;
-	m_indexC = m_bodyC->m_islandIndex;
-	m_indexD = m_bodyD->m_islandIndex;
+	m_indexA = b2Island::GetIndex(m_bodyA, data);
+	m_indexB = b2Island::GetIndex(m_bodyB, data);
+	m_indexC = b2Island::GetIndex(m_bodyC, data);
+	m_indexD = b2Island::GetIndex(m_bodyD, data);
 	m_lcA = m_bodyA->m_sweep.localCenter;
 	m_lcB = m_bodyB->m_sweep.localCenter;
 	m_lcC = m_bodyC->m_sweep.localCenter;
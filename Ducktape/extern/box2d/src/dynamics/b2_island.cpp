@@ -26,12 +26,16 @@
 #include "box2d/b2_fixture.h"
 #include "box2d/b2_joint.h"
 #include "box2d/b2_stack_allocator.h"
+#include "box2d/b2_task.h"
 #include "box2d/b2_timer.h"
 #include "box2d/b2_world.h"
 
 #include "b2_island.h"
 #include "dynamics/b2_contact_solver.h"
 
+#include <algorithm>
+#include <functional>
+
 /*
 Position Correction Notes
 =========================
@@ -167,6 +171,9 @@ b2Island::b2Island(
 	m_allocator = allocator;
 	m_listener = listener;
 
+	m_statics = nullptr;
+	m_staticCount = 0;
+
 	m_bodies = (b2Body**)m_allocator->Allocate(bodyCapacity * sizeof(b2Body*));
 	m_contacts = (b2Contact**)m_allocator->Allocate(contactCapacity	 * sizeof(b2Contact*));
 	m_joints = (b2Joint**)m_allocator->Allocate(jointCapacity * sizeof(b2Joint*));
@@ -201,9 +208,13 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 		b2Vec2 v = b->m_linearVelocity;
 		float w = b->m_angularVelocity;
 
-		// Store positions for continuous collision.
-		b->m_sweep.c0 = b->m_sweep.c;
-		b->m_sweep.a0 = b->m_sweep.a;
+		// Store positions for continuous collision. Static bodies never move, and can be
+		// shared with islands solved on other threads, so they're left untouched.
+		if (b->m_type != b2_staticBody)
+		{
+			b->m_sweep.c0 = b->m_sweep.c;
+			b->m_sweep.a0 = b->m_sweep.a;
+		}
 
 		if (b->m_type == b2_dynamicBody)
 		{
@@ -235,6 +246,8 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 	solverData.step = step;
 	solverData.positions = m_positions;
 	solverData.velocities = m_velocities;
+	solverData.statics = m_statics;
+	solverData.staticCount = m_staticCount;
 
 	// Initialize velocity constraints.
 	b2ContactSolverDef contactSolverDef;
@@ -244,6 +257,8 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 	contactSolverDef.positions = m_positions;
 	contactSolverDef.velocities = m_velocities;
 	contactSolverDef.allocator = m_allocator;
+	contactSolverDef.statics = m_statics;
+	contactSolverDef.staticCount = m_staticCount;
 
 	b2ContactSolver contactSolver(&contactSolverDef);
 	contactSolver.InitializeVelocityConstraints();
@@ -335,6 +350,11 @@ void b2Island::Solve(b2Profile* profile, const b2TimeStep& step, const b2Vec2& g
 	for (int32 i = 0; i < m_bodyCount; ++i)
 	{
 		b2Body* body = m_bodies[i];
+		if (body->m_type == b2_staticBody)
+		{
+			continue;
+		}
+
 		body->m_sweep.c = m_positions[i].c;
 		body->m_sweep.a = m_positions[i].a;
 		body->m_linearVelocity = m_velocities[i].v;
@@ -408,6 +428,8 @@ void b2Island::SolveTOI(const b2TimeStep& subStep, int32 toiIndexA, int32 toiInd
 	contactSolverDef.step = subStep;
 	contactSolverDef.positions = m_positions;
 	contactSolverDef.velocities = m_velocities;
+	contactSolverDef.statics = m_statics;
+	contactSolverDef.staticCount = m_staticCount;
 	b2ContactSolver contactSolver(&contactSolverDef);
 
 	// Solve position constraints.
@@ -518,6 +540,38 @@ void b2Island::SolveTOI(const b2TimeStep& subStep, int32 toiIndexA, int32 toiInd
 	Report(contactSolver.m_velocityConstraints);
 }
 
+int32 b2Island::GetIndex(const b2Body* body, const b2StaticIndex* statics, int32 staticCount)
+{
+	if (statics == nullptr || body->m_type != b2_staticBody)
+	{
+		return body->m_islandIndex;
+	}
+
+	// Binary search, the statics are sorted by body.
+	int32 low = 0;
+	int32 high = staticCount - 1;
+	while (low <= high)
+	{
+		int32 mid = (low + high) / 2;
+		if (statics[mid].body == body)
+		{
+			return statics[mid].index;
+		}
+
+		if (std::less<const b2Body*>()(statics[mid].body, body))
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid - 1;
+		}
+	}
+
+	b2Assert(false);
+	return body->m_islandIndex;
+}
+
 void b2Island::Report(const b2ContactVelocityConstraint* constraints)
 {
 	if (m_listener == nullptr)
@@ -542,3 +596,184 @@ void b2Island::Report(const b2ContactVelocityConstraint* constraints)
 		m_listener->PostSolve(c, &impulse);
 	}
 }
+
+
+namespace
+{
+	class b2SolveIslandsTask : public b2Task
+	{
+	public:
+		explicit b2SolveIslandsTask(b2IslandBatch* batch) : m_batch(batch) {}
+
+		void Execute(int32 begin, int32 end, int32 threadIndex) override
+		{
+			for (int32 i = begin; i < end; ++i)
+			{
+				m_batch->SolveIsland(i, threadIndex);
+			}
+		}
+
+	private:
+		b2IslandBatch* m_batch;
+	};
+}
+
+b2IslandBatch::b2IslandBatch()
+{
+	m_allocators = nullptr;
+	m_allocatorCount = 0;
+	m_allowSleep = true;
+}
+
+b2IslandBatch::~b2IslandBatch()
+{
+	delete[] m_allocators;
+}
+
+void b2IslandBatch::Clear()
+{
+	m_bodies.clear();
+	m_contacts.clear();
+	m_joints.clear();
+	m_statics.clear();
+	m_islands.clear();
+}
+
+void b2IslandBatch::BeginIsland()
+{
+	Range range;
+	range.bodyStart = int32(m_bodies.size());
+	range.contactStart = int32(m_contacts.size());
+	range.jointStart = int32(m_joints.size());
+	range.staticStart = int32(m_statics.size());
+	range.bodyCount = 0;
+	range.contactCount = 0;
+	range.jointCount = 0;
+	range.staticCount = 0;
+	m_islands.push_back(range);
+}
+
+void b2IslandBatch::EndIsland()
+{
+	Range& range = m_islands.back();
+	range.bodyCount = int32(m_bodies.size()) - range.bodyStart;
+	range.contactCount = int32(m_contacts.size()) - range.contactStart;
+	range.jointCount = int32(m_joints.size()) - range.jointStart;
+	range.staticCount = int32(m_statics.size()) - range.staticStart;
+
+	b2StaticIndex* statics = m_statics.data() + range.staticStart;
+	std::sort(statics, statics + range.staticCount, [](const b2StaticIndex& a, const b2StaticIndex& b)
+	{
+		return std::less<const b2Body*>()(a.body, b.body);
+	});
+
+	// Allow static bodies to participate in other islands.
+	for (int32 i = 0; i < range.staticCount; ++i)
+	{
+		const_cast<b2Body*>(statics[i].body)->m_flags &= ~b2Body::e_islandFlag;
+	}
+}
+
+void b2IslandBatch::Add(b2Body* body)
+{
+	const Range& range = m_islands.back();
+	int32 index = int32(m_bodies.size()) - range.bodyStart;
+	if (body->m_type == b2_staticBody)
+	{
+		b2StaticIndex entry;
+		entry.body = body;
+		entry.index = index;
+		m_statics.push_back(entry);
+	}
+	else
+	{
+		body->m_islandIndex = index;
+	}
+	m_bodies.push_back(body);
+}
+
+void b2IslandBatch::Add(b2Contact* contact)
+{
+	m_contacts.push_back(contact);
+}
+
+void b2IslandBatch::Add(b2Joint* joint)
+{
+	m_joints.push_back(joint);
+}
+
+void b2IslandBatch::Solve(b2TaskExecutor* executor, b2Profile* profile, const b2TimeStep& step, const b2Vec2& gravity, bool allowSleep,
+						  b2ContactListener* listener)
+{
+	int32 threadCount = b2Max(executor->GetThreadCount(), 1);
+	if (threadCount != m_allocatorCount)
+	{
+		delete[] m_allocators;
+		m_allocators = new b2StackAllocator[threadCount];
+		m_allocatorCount = threadCount;
+	}
+
+	m_step = step;
+	m_gravity = gravity;
+	m_allowSleep = allowSleep;
+
+	int32 islandCount = int32(m_islands.size());
+	m_profiles.resize(islandCount);
+
+	b2SolveIslandsTask task(this);
+	executor->ParallelFor(&task, islandCount, 4);
+
+	// Merge in island order, so the result doesn't depend on how the islands were scheduled.
+	for (int32 i = 0; i < islandCount; ++i)
+	{
+		profile->solveInit += m_profiles[i].solveInit;
+		profile->solveVelocity += m_profiles[i].solveVelocity;
+		profile->solvePosition += m_profiles[i].solvePosition;
+	}
+
+	if (listener == nullptr)
+	{
+		return;
+	}
+
+	// The solver stored the impulses in the manifolds, report them like b2Island::Report.
+	for (b2Contact* contact : m_contacts)
+	{
+		const b2Manifold* manifold = contact->GetManifold();
+
+		b2ContactImpulse impulse;
+		impulse.count = manifold->pointCount;
+		for (int32 j = 0; j < manifold->pointCount; ++j)
+		{
+			impulse.normalImpulses[j] = manifold->points[j].normalImpulse;
+			impulse.tangentImpulses[j] = manifold->points[j].tangentImpulse;
+		}
+
+		listener->PostSolve(contact, &impulse);
+	}
+}
+
+void b2IslandBatch::SolveIsland(int32 index, int32 threadIndex)
+{
+	b2Assert(0 <= threadIndex && threadIndex < m_allocatorCount);
+	const Range& range = m_islands[index];
+
+	b2Island island(range.bodyCount, range.contactCount, range.jointCount, m_allocators + threadIndex, nullptr);
+	island.m_statics = m_statics.data() + range.staticStart;
+	island.m_staticCount = range.staticCount;
+
+	for (int32 i = 0; i < range.bodyCount; ++i)
+	{
+		island.Add(m_bodies[range.bodyStart + i]);
+	}
+	for (int32 i = 0; i < range.contactCount; ++i)
+	{
+		island.Add(m_contacts[range.contactStart + i]);
+	}
+	for (int32 i = 0; i < range.jointCount; ++i)
+	{
+		island.Add(m_joints[range.jointStart + i]);
+	}
+
+	island.Solve(&m_profiles[index], m_step, m_gravity, m_allowSleep);
+}
@@ -27,7 +27,10 @@
 #include "box2d/b2_math.h"
 #include "box2d/b2_time_step.h"
 
+#include <vector>
+
 class b2Contact;
+class b2TaskExecutor;
 class b2Joint;
 class b2StackAllocator;
 class b2ContactListener;
@@ -56,7 +59,12 @@ public:
 	void Add(b2Body* body)
 	{
 		b2Assert(m_bodyCount < m_bodyCapacity);
-		body->m_islandIndex = m_bodyCount;
+
+		// Shared static bodies have their index in m_statics instead.
+		if (m_statics == nullptr || body->m_type != b2_staticBody)
+		{
+			body->m_islandIndex = m_bodyCount;
+		}
 		m_bodies[m_bodyCount] = body;
 		++m_bodyCount;
 	}
@@ -75,6 +83,14 @@ public:
 
 	void Report(const b2ContactVelocityConstraint* constraints);
 
+	/// Get the index of a body in the island being solved.
+	static int32 GetIndex(const b2Body* body, const b2StaticIndex* statics, int32 staticCount);
+
+	static int32 GetIndex(const b2Body* body, const b2SolverData& data)
+	{
+		return GetIndex(body, data.statics, data.staticCount);
+	}
+
 	b2StackAllocator* m_allocator;
 	b2ContactListener* m_listener;
 
@@ -85,6 +101,11 @@ public:
 	b2Position* m_positions;
 	b2Velocity* m_velocities;
 
+	// Set when the island shares its static bodies with other islands solved at the same time.
+	// Sorted by body.
+	const b2StaticIndex* m_statics;
+	int32 m_staticCount;
+
 	int32 m_bodyCount;
 	int32 m_jointCount;
 	int32 m_contactCount;
@@ -94,4 +115,53 @@ public:
 	int32 m_jointCapacity;
 };
 
+/// The awake islands of a step, gathered up front so they can be solved in parallel by a
+/// b2TaskExecutor. The buffers are kept between steps.
+/// This is an internal class.
+class b2IslandBatch
+{
+public:
+	b2IslandBatch();
+	~b2IslandBatch();
+
+	void Clear();
+
+	void BeginIsland();
+	void EndIsland();
+
+	void Add(b2Body* body);
+	void Add(b2Contact* contact);
+	void Add(b2Joint* joint);
+
+	/// Solve every island, each on the thread picked by the executor with its own stack
+	/// allocator, then report the impulses to the listener in island order.
+	void Solve(b2TaskExecutor* executor, b2Profile* profile, const b2TimeStep& step, const b2Vec2& gravity, bool allowSleep,
+			   b2ContactListener* listener);
+
+	void SolveIsland(int32 index, int32 threadIndex);
+
+	struct Range
+	{
+		int32 bodyStart, bodyCount;
+		int32 contactStart, contactCount;
+		int32 jointStart, jointCount;
+		int32 staticStart, staticCount;
+	};
+
+	std::vector<b2Body*> m_bodies;
+	std::vector<b2Contact*> m_contacts;
+	std::vector<b2Joint*> m_joints;
+	std::vector<b2StaticIndex> m_statics;
+	std::vector<Range> m_islands;
+	std::vector<b2Profile> m_profiles;
+
+	b2StackAllocator* m_allocators;
+	int32 m_allocatorCount;
+
+	// Parameters of the step being solved.
+	b2TimeStep m_step;
+	b2Vec2 m_gravity;
+	bool m_allowSleep;
+};
+
 #endif
@@ -29,22 +29,36 @@
 #include "box2d/b2_circle_shape.h"
 #include "box2d/b2_collision.h"
 #include "box2d/b2_contact.h"
+#include "box2d/b2_distance_joint.h"
 #include "box2d/b2_draw.h"
 #include "box2d/b2_edge_shape.h"
 #include "box2d/b2_fixture.h"
+#include "box2d/b2_friction_joint.h"
+#include "box2d/b2_gear_joint.h"
+#include "box2d/b2_motor_joint.h"
+#include "box2d/b2_mouse_joint.h"
 #include "box2d/b2_polygon_shape.h"
+#include "box2d/b2_prismatic_joint.h"
 #include "box2d/b2_pulley_joint.h"
+#include "box2d/b2_revolute_joint.h"
 #include "box2d/b2_time_of_impact.h"
 #include "box2d/b2_timer.h"
+#include "box2d/b2_weld_joint.h"
+#include "box2d/b2_wheel_joint.h"
 #include "box2d/b2_world.h"
+#include "box2d/b2_world_state.h"
 
 #include <new>
+#include <string.h>
 
 b2World::b2World(const b2Vec2& gravity)
 {
 	m_destructionListener = nullptr;
 	m_debugDraw = nullptr;
 
+	m_taskExecutor = nullptr;
+	m_islandBatch = nullptr;
+
 	m_bodyList = nullptr;
 	m_jointList = nullptr;
 
@@ -90,6 +104,12 @@ b2World::~b2World()
 
 		b = bNext;
 	}
+
+	if (m_islandBatch)
+	{
+		m_islandBatch->~b2IslandBatch();
+		b2Free(m_islandBatch);
+	}
 }
 
 void b2World::SetDestructionListener(b2DestructionListener* listener)
@@ -97,6 +117,12 @@ void b2World::SetDestructionListener(b2DestructionListener* listener)
 	m_destructionListener = listener;
 }
 
+void b2World::SetTaskExecutor(b2TaskExecutor* executor)
+{
+	m_taskExecutor = executor;
+	m_contactManager.m_taskExecutor = executor;
+}
+
 void b2World::SetContactFilter(b2ContactFilter* filter)
 {
 	m_contactManager.m_contactFilter = filter;
@@ -390,6 +416,104 @@ void b2World::SetAllowSleeping(bool flag)
 	}
 }
 
+// Add the island connected to the seed body, using a depth first search on the constraint graph.
+template <typename T>
+void b2World::AddIsland(b2Body* seed, b2Body** stack, int32 stackSize, T* island)
+{
+	int32 stackCount = 0;
+	stack[stackCount++] = seed;
+	seed->m_flags |= b2Body::e_islandFlag;
+
+	while (stackCount > 0)
+	{
+		// Grab the next body off the stack and add it to the island.
+		b2Body* b = stack[--stackCount];
+		b2Assert(b->IsEnabled() == true);
+		island->Add(b);
+
+		// To keep islands as small as possible, we don't
+		// propagate islands across static bodies.
+		if (b->GetType() == b2_staticBody)
+		{
+			continue;
+		}
+
+		// Make sure the body is awake (without resetting sleep timer).
+		b->m_flags |= b2Body::e_awakeFlag;
+
+		// Search all contacts connected to this body.
+		for (b2ContactEdge* ce = b->m_contactList; ce; ce = ce->next)
+		{
+			b2Contact* contact = ce->contact;
+
+			// Has this contact already been added to an island?
+			if (contact->m_flags & b2Contact::e_islandFlag)
+			{
+				continue;
+			}
+
+			// Is this contact solid and touching?
+			if (contact->IsEnabled() == false ||
+				contact->IsTouching() == false)
+			{
+				continue;
+			}
+
+			// Skip sensors.
+			bool sensorA = contact->m_fixtureA->m_isSensor;
+			bool sensorB = contact->m_fixtureB->m_isSensor;
+			if (sensorA || sensorB)
+			{
+				continue;
+			}
+
+			island->Add(contact);
+			contact->m_flags |= b2Contact::e_islandFlag;
+
+			b2Body* other = ce->other;
+
+			// Was the other body already added to this island?
+			if (other->m_flags & b2Body::e_islandFlag)
+			{
+				continue;
+			}
+
+			b2Assert(stackCount < stackSize);
+			stack[stackCount++] = other;
+			other->m_flags |= b2Body::e_islandFlag;
+		}
+
+		// Search all joints connect to this body.
+		for (b2JointEdge* je = b->m_jointList; je; je = je->next)
+		{
+			if (je->joint->m_islandFlag == true)
+			{
+				continue;
+			}
+
+			b2Body* other = je->other;
+
+			// Don't simulate joints connected to diabled bodies.
+			if (other->IsEnabled() == false)
+			{
+				continue;
+			}
+
+			island->Add(je->joint);
+			je->joint->m_islandFlag = true;
+
+			if (other->m_flags & b2Body::e_islandFlag)
+			{
+				continue;
+			}
+
+			b2Assert(stackCount < stackSize);
+			stack[stackCount++] = other;
+			other->m_flags |= b2Body::e_islandFlag;
+		}
+	}
+}
+
 // Find islands, integrate and solve constraints, solve position constraints
 void b2World::Solve(const b2TimeStep& step)
 {
@@ -397,13 +521,6 @@ void b2World::Solve(const b2TimeStep& step)
 	m_profile.solveVelocity = 0.0f;
 	m_profile.solvePosition = 0.0f;
 
-	// Size the island for the worst case.
-	b2Island island(m_bodyCount,
-					m_contactManager.m_contactCount,
-					m_jointCount,
-					&m_stackAllocator,
-					m_contactManager.m_contactListener);
-
 	// Clear all the island flags.
 	for (b2Body* b = m_bodyList; b; b = b->m_next)
 	{
@@ -418,143 +535,65 @@ void b2World::Solve(const b2TimeStep& step)
 		j->m_islandFlag = false;
 	}
 
-	// Build and simulate all awake islands.
-	int32 stackSize = m_bodyCount;
-	b2Body** stack = (b2Body**)m_stackAllocator.Allocate(stackSize * sizeof(b2Body*));
-	for (b2Body* seed = m_bodyList; seed; seed = seed->m_next)
+	if (m_taskExecutor != nullptr && m_taskExecutor->GetThreadCount() > 1)
 	{
-		if (seed->m_flags & b2Body::e_islandFlag)
-		{
-			continue;
-		}
-
-		if (seed->IsAwake() == false || seed->IsEnabled() == false)
-		{
-			continue;
-		}
-
-		// The seed can be dynamic or kinematic.
-		if (seed->GetType() == b2_staticBody)
-		{
-			continue;
-		}
-
-		// Reset island and stack.
-		island.Clear();
-		int32 stackCount = 0;
-		stack[stackCount++] = seed;
-		seed->m_flags |= b2Body::e_islandFlag;
-
-		// Perform a depth first search (DFS) on the constraint graph.
-		while (stackCount > 0)
+		SolveParallel(step);
+	}
+	else
+	{
+		// Size the island for the worst case.
+		b2Island island(m_bodyCount,
+						m_contactManager.m_contactCount,
+						m_jointCount,
+						&m_stackAllocator,
+						m_contactManager.m_contactListener);
+
+		// Build and simulate all awake islands.
+		int32 stackSize = m_bodyCount;
+		b2Body** stack = (b2Body**)m_stackAllocator.Allocate(stackSize * sizeof(b2Body*));
+		for (b2Body* seed = m_bodyList; seed; seed = seed->m_next)
 		{
-			// Grab the next body off the stack and add it to the island.
-			b2Body* b = stack[--stackCount];
-			b2Assert(b->IsEnabled() == true);
-			island.Add(b);
-
-			// To keep islands as small as possible, we don't
-			// propagate islands across static bodies.
-			if (b->GetType() == b2_staticBody)
+			if (seed->m_flags & b2Body::e_islandFlag)
 			{
 				continue;
 			}
 
-			// Make sure the body is awake (without resetting sleep timer).
-			b->m_flags |= b2Body::e_awakeFlag;
-
-			// Search all contacts connected to this body.
-			for (b2ContactEdge* ce = b->m_contactList; ce; ce = ce->next)
+			if (seed->IsAwake() == false || seed->IsEnabled() == false)
 			{
-				b2Contact* contact = ce->contact;
-
-				// Has this contact already been added to an island?
-				if (contact->m_flags & b2Contact::e_islandFlag)
-				{
-					continue;
-				}
-
-				// Is this contact solid and touching?
-				if (contact->IsEnabled() == false ||
-					contact->IsTouching() == false)
-				{
-					continue;
-				}
-
-				// Skip sensors.
-				bool sensorA = contact->m_fixtureA->m_isSensor;
-				bool sensorB = contact->m_fixtureB->m_isSensor;
-				if (sensorA || sensorB)
-				{
-					continue;
-				}
-
-				island.Add(contact);
-				contact->m_flags |= b2Contact::e_islandFlag;
-
-				b2Body* other = ce->other;
-
-				// Was the other body already added to this island?
-				if (other->m_flags & b2Body::e_islandFlag)
-				{
-					continue;
-				}
-
-				b2Assert(stackCount < stackSize);
-				stack[stackCount++] = other;
-				other->m_flags |= b2Body::e_islandFlag;
+				continue;
 			}
 
-			// Search all joints connect to this body.
-			for (b2JointEdge* je = b->m_jointList; je; je = je->next)
+			// The seed can be dynamic or kinematic.
+			if (seed->GetType() == b2_staticBody)
 			{
-				if (je->joint->m_islandFlag == true)
-				{
-					continue;
-				}
-
-				b2Body* other = je->other;
+				continue;
+			}
 
-				// Don't simulate joints connected to diabled bodies.
-				if (other->IsEnabled() == false)
-				{
-					continue;
-				}
+			// Reset island and stack.
+			island.Clear();
+			AddIsland(seed, stack, stackSize, &island);
 
-				island.Add(je->joint);
-				je->joint->m_islandFlag = true;
+			b2Profile profile;
+			island.Solve(&profile, step, m_gravity, m_allowSleep);
+			m_profile.solveInit += profile.solveInit;
+			m_profile.solveVelocity += profile.solveVelocity;
+			m_profile.solvePosition += profile.solvePosition;
 
-				if (other->m_flags & b2Body::e_islandFlag)
+			// Post solve cleanup.
+			for (int32 i = 0; i < island.m_bodyCount; ++i)
+			{
+				// Allow static bodies to participate in other islands.
+				b2Body* b = island.m_bodies[i];
+				if (b->GetType() == b2_staticBody)
 				{
-					continue;
+					b->m_flags &= ~b2Body::e_islandFlag;
 				}
-
-				b2Assert(stackCount < stackSize);
-				stack[stackCount++] = other;
-				other->m_flags |= b2Body::e_islandFlag;
 			}
 		}
 
-		b2Profile profile;
-		island.Solve(&profile, step, m_gravity, m_allowSleep);
-		m_profile.solveInit += profile.solveInit;
-		m_profile.solveVelocity += profile.solveVelocity;
-		m_profile.solvePosition += profile.solvePosition;
-
-		// Post solve cleanup.
-		for (int32 i = 0; i < island.m_bodyCount; ++i)
-		{
-			// Allow static bodies to participate in other islands.
-			b2Body* b = island.m_bodies[i];
-			if (b->GetType() == b2_staticBody)
-			{
-				b->m_flags &= ~b2Body::e_islandFlag;
-			}
-		}
+		m_stackAllocator.Free(stack);
 	}
 
-	m_stackAllocator.Free(stack);
-
 	{
 		b2Timer timer;
 		// Synchronize fixtures, check for out of range bodies.
@@ -581,6 +620,47 @@ void b2World::Solve(const b2TimeStep& step)
 	}
 }
 
+
+// Gather every awake island first, then solve them all in parallel. The islands are gathered
+// in the same order as b2World::Solve, and each one is solved exactly like it would be there.
+void b2World::SolveParallel(const b2TimeStep& step)
+{
+	if (m_islandBatch == nullptr)
+	{
+		void* mem = b2Alloc(sizeof(b2IslandBatch));
+		m_islandBatch = new (mem) b2IslandBatch;
+	}
+	m_islandBatch->Clear();
+
+	int32 stackSize = m_bodyCount;
+	b2Body** stack = (b2Body**)m_stackAllocator.Allocate(stackSize * sizeof(b2Body*));
+	for (b2Body* seed = m_bodyList; seed; seed = seed->m_next)
+	{
+		if (seed->m_flags & b2Body::e_islandFlag)
+		{
+			continue;
+		}
+
+		if (seed->IsAwake() == false || seed->IsEnabled() == false)
+		{
+			continue;
+		}
+
+		// The seed can be dynamic or kinematic.
+		if (seed->GetType() == b2_staticBody)
+		{
+			continue;
+		}
+
+		m_islandBatch->BeginIsland();
+		AddIsland(seed, stack, stackSize, m_islandBatch);
+		m_islandBatch->EndIsland();
+	}
+	m_stackAllocator.Free(stack);
+
+	m_islandBatch->Solve(m_taskExecutor, &m_profile, step, m_gravity, m_allowSleep, m_contactManager.m_contactListener);
+}
+
 // Find TOI contacts and solve them.
 void b2World::SolveTOI(const b2TimeStep& step)
 {
@@ -1234,6 +1314,34 @@ float b2World::GetTreeQuality() const
 	return m_contactManager.m_broadPhase.GetTreeQuality();
 }
 
+void b2World::RebuildTree()
+{
+	b2Assert(IsLocked() == false);
+	if (IsLocked())
+	{
+		return;
+	}
+
+	m_contactManager.m_broadPhase.RebuildTree();
+}
+
+void b2World::EnableBodies(b2Body* const* bodies, int32 count)
+{
+	b2Assert(IsLocked() == false);
+	if (IsLocked())
+	{
+		return;
+	}
+
+	b2BroadPhase* broadPhase = &m_contactManager.m_broadPhase;
+	broadPhase->BeginBulkInsert();
+	for (int32 i = 0; i < count; ++i)
+	{
+		bodies[i]->SetEnabled(true);
+	}
+	broadPhase->EndBulkInsert();
+}
+
 void b2World::ShiftOrigin(const b2Vec2& newOrigin)
 {
 	b2Assert(m_locked == false);
@@ -1320,3 +1428,386 @@ void b2World::Dump()
 
 	b2CloseDump();
 }
+
+// The layout of a b2WorldState. The records are copied whole, and zeroed first so the
+// padding doesn't make two saves of the same state differ. b2Vec2 has a default constructor,
+// so the records aren't trivial and memset takes them as void* to zero the padding too.
+static const uint32 b2_worldStateMagic = 0x62327773;
+
+struct b2WorldStateHeader
+{
+	uint32 magic;
+	uint32 structure;
+	int32 bodyCount;
+	int32 jointCount;
+	int32 contactCount;
+	b2Vec2 gravity;
+	float inv_dt0;
+	bool newContacts;
+	bool stepComplete;
+};
+
+struct b2BodyState
+{
+	b2Transform xf;
+	b2Sweep sweep;
+	b2Vec2 linearVelocity;
+	b2Vec2 force;
+	float angularVelocity;
+	float torque;
+	float mass, invMass;
+	float I, invI;
+	float linearDamping;
+	float angularDamping;
+	float gravityScale;
+	float sleepTime;
+	int32 type;
+	uint16 flags;
+};
+
+struct b2FixtureState
+{
+	float density;
+	float friction;
+	float restitution;
+	float restitutionThreshold;
+	b2Filter filter;
+	bool isSensor;
+	int32 proxyCount;
+};
+
+struct b2ProxyState
+{
+	b2AABB aabb;
+	int32 proxyId;
+};
+
+struct b2ContactState
+{
+	b2Fixture* fixtureA;
+	b2Fixture* fixtureB;
+	int32 indexA;
+	int32 indexB;
+	uint32 flags;
+	int32 toiCount;
+	float toi;
+	float friction;
+	float restitution;
+	float restitutionThreshold;
+	float tangentSpeed;
+	int32 pointCount;
+};
+
+// Follows a contact state that has manifold points, before the points themselves.
+struct b2ManifoldState
+{
+	b2Vec2 localNormal;
+	b2Vec2 localPoint;
+	int32 type;
+};
+
+// The joints are saved as the bytes of their own class past the b2Joint base, which hold
+// their parameters and accumulated impulses. The base only links the joint into the world.
+static int32 b2GetJointStateSize(b2JointType type)
+{
+	switch (type)
+	{
+	case e_distanceJoint:
+		return sizeof(b2DistanceJoint) - sizeof(b2Joint);
+	case e_frictionJoint:
+		return sizeof(b2FrictionJoint) - sizeof(b2Joint);
+	case e_gearJoint:
+		return sizeof(b2GearJoint) - sizeof(b2Joint);
+	case e_motorJoint:
+		return sizeof(b2MotorJoint) - sizeof(b2Joint);
+	case e_mouseJoint:
+		return sizeof(b2MouseJoint) - sizeof(b2Joint);
+	case e_prismaticJoint:
+		return sizeof(b2PrismaticJoint) - sizeof(b2Joint);
+	case e_pulleyJoint:
+		return sizeof(b2PulleyJoint) - sizeof(b2Joint);
+	case e_revoluteJoint:
+		return sizeof(b2RevoluteJoint) - sizeof(b2Joint);
+	case e_weldJoint:
+		return sizeof(b2WeldJoint) - sizeof(b2Joint);
+	case e_wheelJoint:
+		return sizeof(b2WheelJoint) - sizeof(b2Joint);
+	default:
+		b2Assert(false);
+		return 0;
+	}
+}
+
+// FNV-1a over 32 bit words rather than bytes, this runs on every save and restore.
+static uint32 b2HashValue(uint32 hash, uint64_t value)
+{
+	hash = (hash ^ (uint32)value) * 16777619u;
+	hash = (hash ^ (uint32)(value >> 32)) * 16777619u;
+	return hash;
+}
+
+// Hash of the bodies, fixtures and joints of the world, to tell if a state was saved from it.
+uint32 b2World::ComputeStructureHash() const
+{
+	uint32 hash = 2166136261u;
+	for (b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		hash = b2HashValue(hash, (uintptr_t)b);
+		for (b2Fixture* f = b->m_fixtureList; f; f = f->m_next)
+		{
+			hash = b2HashValue(hash, (uintptr_t)f);
+			hash = b2HashValue(hash, (uintptr_t)f->m_shape);
+			hash = b2HashValue(hash, (uintptr_t)f->m_proxies);
+			hash = b2HashValue(hash, f->m_shape->GetChildCount());
+		}
+	}
+
+	for (b2Joint* j = m_jointList; j; j = j->m_next)
+	{
+		hash = b2HashValue(hash, (uintptr_t)j);
+		hash = b2HashValue(hash, j->m_type);
+	}
+	return hash;
+}
+
+void b2World::SaveState(b2WorldState* state)
+{
+	b2Assert(IsLocked() == false);
+	if (IsLocked())
+	{
+		return;
+	}
+
+	state->Clear();
+
+	b2WorldStateHeader header;
+	memset((void*)&header, 0, sizeof(header));
+	header.magic = b2_worldStateMagic;
+	header.structure = ComputeStructureHash();
+	header.bodyCount = m_bodyCount;
+	header.jointCount = m_jointCount;
+	header.contactCount = m_contactManager.m_contactCount;
+	header.gravity = m_gravity;
+	header.inv_dt0 = m_inv_dt0;
+	header.newContacts = m_newContacts;
+	header.stepComplete = m_stepComplete;
+	state->Write(header);
+
+	for (b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		b2BodyState bs;
+		memset((void*)&bs, 0, sizeof(bs));
+		bs.xf = b->m_xf;
+		bs.sweep = b->m_sweep;
+		bs.linearVelocity = b->m_linearVelocity;
+		bs.force = b->m_force;
+		bs.angularVelocity = b->m_angularVelocity;
+		bs.torque = b->m_torque;
+		bs.mass = b->m_mass;
+		bs.invMass = b->m_invMass;
+		bs.I = b->m_I;
+		bs.invI = b->m_invI;
+		bs.linearDamping = b->m_linearDamping;
+		bs.angularDamping = b->m_angularDamping;
+		bs.gravityScale = b->m_gravityScale;
+		bs.sleepTime = b->m_sleepTime;
+		bs.type = b->m_type;
+		bs.flags = b->m_flags;
+		state->Write(bs);
+
+		for (b2Fixture* f = b->m_fixtureList; f; f = f->m_next)
+		{
+			b2FixtureState fs;
+			memset((void*)&fs, 0, sizeof(fs));
+			fs.density = f->m_density;
+			fs.friction = f->m_friction;
+			fs.restitution = f->m_restitution;
+			fs.restitutionThreshold = f->m_restitutionThreshold;
+			fs.filter = f->m_filter;
+			fs.isSensor = f->m_isSensor;
+			fs.proxyCount = f->m_proxyCount;
+			state->Write(fs);
+
+			for (int32 i = 0; i < f->m_proxyCount; ++i)
+			{
+				b2ProxyState ps;
+				memset((void*)&ps, 0, sizeof(ps));
+				ps.aabb = f->m_proxies[i].aabb;
+				ps.proxyId = f->m_proxies[i].proxyId;
+				state->Write(ps);
+			}
+		}
+	}
+
+	for (b2Joint* j = m_jointList; j; j = j->m_next)
+	{
+		state->Write((const char*)j + sizeof(b2Joint), b2GetJointStateSize(j->m_type));
+	}
+
+	m_contactManager.m_broadPhase.SaveState(state);
+
+	// The contacts are saved last to first, see RestoreState.
+	b2Contact* last = m_contactManager.m_contactList;
+	while (last && last->m_next)
+	{
+		last = last->m_next;
+	}
+
+	for (b2Contact* c = last; c; c = c->m_prev)
+	{
+		const b2Manifold& manifold = c->m_manifold;
+
+		b2ContactState cs;
+		memset((void*)&cs, 0, sizeof(cs));
+		cs.fixtureA = c->m_fixtureA;
+		cs.fixtureB = c->m_fixtureB;
+		cs.indexA = c->m_indexA;
+		cs.indexB = c->m_indexB;
+		cs.flags = c->m_flags;
+		cs.toiCount = c->m_toiCount;
+		cs.toi = c->m_toi;
+		cs.friction = c->m_friction;
+		cs.restitution = c->m_restitution;
+		cs.restitutionThreshold = c->m_restitutionThreshold;
+		cs.tangentSpeed = c->m_tangentSpeed;
+		cs.pointCount = manifold.pointCount;
+		state->Write(cs);
+
+		// Only the points in use are saved, the rest of the manifold holds stale data.
+		if (manifold.pointCount > 0)
+		{
+			b2ManifoldState ms;
+			memset((void*)&ms, 0, sizeof(ms));
+			ms.localNormal = manifold.localNormal;
+			ms.localPoint = manifold.localPoint;
+			ms.type = manifold.type;
+			state->Write(ms);
+			state->Write(manifold.points, manifold.pointCount * sizeof(b2ManifoldPoint));
+		}
+	}
+}
+
+bool b2World::RestoreState(const b2WorldState* state)
+{
+	b2Assert(IsLocked() == false);
+	if (IsLocked())
+	{
+		return false;
+	}
+
+	b2WorldStateReader reader(state);
+
+	b2WorldStateHeader header;
+	if (reader.Read(&header) == false || header.magic != b2_worldStateMagic ||
+		header.bodyCount != m_bodyCount || header.jointCount != m_jointCount ||
+		header.structure != ComputeStructureHash())
+	{
+		return false;
+	}
+
+	// Drop the current contacts without reporting them, the saved ones replace them.
+	b2ContactListener* listener = m_contactManager.m_contactListener;
+	m_contactManager.m_contactListener = nullptr;
+	while (m_contactManager.m_contactList)
+	{
+		m_contactManager.Destroy(m_contactManager.m_contactList);
+	}
+	m_contactManager.m_contactListener = listener;
+
+	bool valid = true;
+
+	for (b2Body* b = m_bodyList; b; b = b->m_next)
+	{
+		b2BodyState bs;
+		valid = valid && reader.Read(&bs);
+		b->m_xf = bs.xf;
+		b->m_sweep = bs.sweep;
+		b->m_linearVelocity = bs.linearVelocity;
+		b->m_force = bs.force;
+		b->m_angularVelocity = bs.angularVelocity;
+		b->m_torque = bs.torque;
+		b->m_mass = bs.mass;
+		b->m_invMass = bs.invMass;
+		b->m_I = bs.I;
+		b->m_invI = bs.invI;
+		b->m_linearDamping = bs.linearDamping;
+		b->m_angularDamping = bs.angularDamping;
+		b->m_gravityScale = bs.gravityScale;
+		b->m_sleepTime = bs.sleepTime;
+		b->m_type = (b2BodyType)bs.type;
+		b->m_flags = bs.flags;
+
+		for (b2Fixture* f = b->m_fixtureList; f; f = f->m_next)
+		{
+			b2FixtureState fs;
+			valid = valid && reader.Read(&fs);
+			f->m_density = fs.density;
+			f->m_friction = fs.friction;
+			f->m_restitution = fs.restitution;
+			f->m_restitutionThreshold = fs.restitutionThreshold;
+			f->m_filter = fs.filter;
+			f->m_isSensor = fs.isSensor;
+			f->m_proxyCount = fs.proxyCount;
+
+			b2Assert(0 <= fs.proxyCount && fs.proxyCount <= f->m_shape->GetChildCount());
+			for (int32 i = 0; i < f->m_proxyCount; ++i)
+			{
+				b2ProxyState ps;
+				valid = valid && reader.Read(&ps);
+				f->m_proxies[i].aabb = ps.aabb;
+				f->m_proxies[i].proxyId = ps.proxyId;
+			}
+		}
+	}
+
+	for (b2Joint* j = m_jointList; j; j = j->m_next)
+	{
+		valid = valid && reader.Read((char*)j + sizeof(b2Joint), b2GetJointStateSize(j->m_type));
+	}
+
+	valid = valid && m_contactManager.m_broadPhase.RestoreState(&reader);
+
+	// New contacts go to the front of the contact lists of the world and of both bodies, so
+	// creating the contacts in the order they were saved, last to first, puts all of these
+	// lists back in their saved order.
+	for (int32 i = 0; valid && i < header.contactCount; ++i)
+	{
+		b2ContactState cs;
+		valid = reader.Read(&cs) && 0 <= cs.pointCount && cs.pointCount <= b2_maxManifoldPoints;
+		if (valid == false)
+		{
+			break;
+		}
+
+		b2Contact* c = b2Contact::Create(cs.fixtureA, cs.indexA, cs.fixtureB, cs.indexB, &m_blockAllocator);
+		b2Assert(c != nullptr && c->m_fixtureA == cs.fixtureA);
+		c->m_flags = cs.flags;
+		c->m_toiCount = cs.toiCount;
+		c->m_toi = cs.toi;
+		c->m_friction = cs.friction;
+		c->m_restitution = cs.restitution;
+		c->m_restitutionThreshold = cs.restitutionThreshold;
+		c->m_tangentSpeed = cs.tangentSpeed;
+		m_contactManager.Insert(c);
+
+		b2Manifold& manifold = c->m_manifold;
+		manifold.pointCount = cs.pointCount;
+		if (cs.pointCount > 0)
+		{
+			b2ManifoldState ms;
+			valid = reader.Read(&ms) && reader.Read(manifold.points, cs.pointCount * sizeof(b2ManifoldPoint));
+			manifold.localNormal = ms.localNormal;
+			manifold.localPoint = ms.localPoint;
+			manifold.type = (b2Manifold::Type)ms.type;
+		}
+	}
+
+	// The state was saved from this world, so it can only be cut short if it was corrupted.
+	b2Assert(valid && reader.GetRemaining() == 0);
+
+	m_gravity = header.gravity;
+	m_inv_dt0 = header.inv_dt0;
+	m_newContacts = header.newContacts;
+	m_stepComplete = header.stepComplete;
+	return valid;
+}
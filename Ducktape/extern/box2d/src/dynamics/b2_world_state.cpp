@@ -0,0 +1,105 @@
+// MIT License
+
+// Copyright (c) 2019 Erin Catto
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "box2d/b2_math.h"
+#include "box2d/b2_world_state.h"
+
+#include <string.h>
+
+b2WorldState::b2WorldState()
+{
+	m_data = nullptr;
+	m_size = 0;
+	m_capacity = 0;
+}
+
+b2WorldState::~b2WorldState()
+{
+	b2Free(m_data);
+}
+
+b2WorldState::b2WorldState(const b2WorldState& other)
+{
+	m_data = nullptr;
+	m_size = 0;
+	m_capacity = 0;
+	if (other.m_size > 0)
+	{
+		Write(other.m_data, other.m_size);
+	}
+}
+
+b2WorldState& b2WorldState::operator=(const b2WorldState& other)
+{
+	if (this != &other)
+	{
+		m_size = 0;
+		if (other.m_size > 0)
+		{
+			Write(other.m_data, other.m_size);
+		}
+	}
+	return *this;
+}
+
+void b2WorldState::Grow(int32 capacity)
+{
+	b2Assert(capacity > m_capacity);
+
+	int32 newCapacity = b2Max(2 * m_capacity, 1024);
+	while (newCapacity < capacity)
+	{
+		newCapacity *= 2;
+	}
+
+	char* data = (char*)b2Alloc(newCapacity);
+	if (m_size > 0)
+	{
+		memcpy(data, m_data, m_size);
+	}
+	b2Free(m_data);
+
+	m_data = data;
+	m_capacity = newCapacity;
+}
+
+b2WorldStateReader::b2WorldStateReader(const b2WorldState* state)
+{
+	m_data = (const char*)state->GetData();
+	m_size = state->GetSize();
+	m_offset = 0;
+}
+
+bool b2WorldStateReader::Read(void* data, int32 size)
+{
+	if (size < 0 || size > m_size - m_offset)
+	{
+		return false;
+	}
+
+	if (size > 0)
+	{
+		memcpy(data, m_data + m_offset, size);
+		m_offset += size;
+	}
+	return true;
+}
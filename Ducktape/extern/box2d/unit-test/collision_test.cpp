@@ -22,7 +22,9 @@
 
 #include "box2d/box2d.h"
 #include "doctest.h"
+#include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 
 // Unit tests for collision algorithms
 DOCTEST_TEST_CASE("collision test")
@@ -79,3 +81,138 @@ DOCTEST_TEST_CASE("collision test")
 		CHECK(b2Abs(massData2.I - inertia) < 40.0f * (absTol + relTol * inertia));
 	}
 }
+
+struct TreeQueryCounter
+{
+	bool QueryCallback(int32 proxyId)
+	{
+		sum += proxyId + 1;
+		++count;
+		return true;
+	}
+
+	int32 count = 0;
+	int64_t sum = 0;
+};
+
+DOCTEST_TEST_CASE("dynamic tree top-down rebuild")
+{
+	b2DynamicTree tree;
+
+	// Rebuilding an empty tree leaves it empty.
+	tree.RebuildTopDown();
+	CHECK(tree.GetHeight() == 0);
+
+	// Insert a tile map row by row, the way a level loader would.
+	const int32 size = 100;
+	int32 ids[size * size];
+	for (int32 y = 0; y < size; ++y)
+	{
+		for (int32 x = 0; x < size; ++x)
+		{
+			b2AABB aabb;
+			aabb.lowerBound.Set(float(x), float(y));
+			aabb.upperBound.Set(x + 1.0f, y + 1.0f);
+			ids[y * size + x] = tree.CreateProxy(aabb, ids + y * size + x);
+		}
+	}
+
+	b2AABB queries[3];
+	queries[0].lowerBound.Set(10.5f, 20.5f);
+	queries[0].upperBound.Set(12.5f, 25.5f);
+	queries[1].lowerBound.Set(-5.0f, -5.0f);
+	queries[1].upperBound.Set(200.0f, 200.0f);
+	queries[2].lowerBound.Set(99.5f, 0.5f);
+	queries[2].upperBound.Set(99.6f, 0.6f);
+
+	TreeQueryCounter before[3];
+	for (int32 i = 0; i < 3; ++i)
+	{
+		tree.Query(before + i, queries[i]);
+	}
+
+	float areaRatio = tree.GetAreaRatio();
+	tree.RebuildTopDown();
+	tree.Validate();
+
+	CHECK(tree.GetAreaRatio() < areaRatio);
+	CHECK(tree.GetMaxBalance() <= 2);
+	CHECK(tree.GetHeight() <= 16);
+
+	// Proxies keep their ids and user data, and queries find the same ones.
+	int32 moved = 0;
+	for (int32 i = 0; i < size * size; ++i)
+	{
+		moved += tree.GetUserData(ids[i]) != ids + i;
+	}
+	CHECK(moved == 0);
+
+	for (int32 i = 0; i < 3; ++i)
+	{
+		TreeQueryCounter after;
+		tree.Query(&after, queries[i]);
+		CHECK(after.count == before[i].count);
+		CHECK(after.sum == before[i].sum);
+	}
+	CHECK(before[1].count == size * size);
+
+	// The tree still supports incremental changes afterwards.
+	tree.DestroyProxy(ids[0]);
+	b2AABB aabb;
+	aabb.lowerBound.Set(-1.0f, -1.0f);
+	aabb.upperBound.Set(0.0f, 0.0f);
+	tree.CreateProxy(aabb, nullptr);
+	tree.Validate();
+}
+
+DOCTEST_TEST_CASE("dynamic tree bulk insert")
+{
+	b2DynamicTree tree;
+
+	b2AABB aabb;
+	aabb.lowerBound.Set(-10.0f, -10.0f);
+	aabb.upperBound.Set(-9.0f, -9.0f);
+	tree.CreateProxy(aabb, nullptr);
+
+	// Detached proxies aren't found until they're inserted.
+	const int32 size = 50;
+	int32 ids[size * size];
+	for (int32 y = 0; y < size; ++y)
+	{
+		for (int32 x = 0; x < size; ++x)
+		{
+			aabb.lowerBound.Set(float(x), float(y));
+			aabb.upperBound.Set(x + 1.0f, y + 1.0f);
+			ids[y * size + x] = tree.CreateDetachedProxy(aabb, ids + y * size + x);
+		}
+	}
+
+	b2AABB everything;
+	everything.lowerBound.Set(-20.0f, -20.0f);
+	everything.upperBound.Set(100.0f, 100.0f);
+
+	TreeQueryCounter before;
+	tree.Query(&before, everything);
+	CHECK(before.count == 1);
+
+	int32 inserted[size * size];
+	memcpy(inserted, ids, sizeof(ids));
+	tree.InsertProxies(inserted, size * size);
+	tree.Validate();
+
+	TreeQueryCounter after;
+	tree.Query(&after, everything);
+	CHECK(after.count == 1 + size * size);
+	CHECK(tree.GetHeight() <= 16);
+
+	int32 moved = 0;
+	for (int32 i = 0; i < size * size; ++i)
+	{
+		moved += tree.GetUserData(ids[i]) != ids + i;
+	}
+	CHECK(moved == 0);
+
+	// Inserted proxies behave like any other.
+	tree.DestroyProxy(ids[0]);
+	tree.Validate();
+}
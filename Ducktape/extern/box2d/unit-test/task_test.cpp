@@ -0,0 +1,248 @@
+// MIT License
+
+// Copyright (c) 2019 Erin Catto
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "box2d/box2d.h"
+#include "doctest.h"
+
+#include <thread>
+#include <vector>
+
+// Runs every range on its own thread.
+class ThreadExecutor : public b2TaskExecutor
+{
+public:
+	explicit ThreadExecutor(int32 threadCount) : m_threadCount(threadCount) {}
+
+	int32 GetThreadCount() const override
+	{
+		return m_threadCount;
+	}
+
+	void ParallelFor(b2Task* task, int32 count, int32 minRange) override
+	{
+		int32 rangeSize = b2Max(minRange, (count + m_threadCount - 1) / m_threadCount);
+		std::vector<std::thread> threads;
+		for (int32 begin = 0, index = 0; begin < count; begin += rangeSize, ++index)
+		{
+			int32 end = b2Min(begin + rangeSize, count);
+			threads.emplace_back([task, begin, end, index]() { task->Execute(begin, end, index); });
+		}
+
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+	}
+
+private:
+	int32 m_threadCount;
+};
+
+class CountingListener : public b2ContactListener
+{
+public:
+	void PostSolve(b2Contact* contact, const b2ContactImpulse* impulse) override
+	{
+		B2_NOT_USED(contact);
+		B2_NOT_USED(impulse);
+		++postSolveCount;
+	}
+
+	int32 postSolveCount = 0;
+};
+
+// Records every touch event, with the bodies identified by their user data.
+class RecordingListener : public b2ContactListener
+{
+public:
+	void BeginContact(b2Contact* contact) override
+	{
+		Record(1, contact);
+	}
+
+	void EndContact(b2Contact* contact) override
+	{
+		Record(2, contact);
+	}
+
+	void Record(uintptr_t type, b2Contact* contact)
+	{
+		events.push_back(type);
+		events.push_back(contact->GetFixtureA()->GetBody()->GetUserData().pointer);
+		events.push_back(contact->GetFixtureB()->GetBody()->GetUserData().pointer);
+	}
+
+	std::vector<uintptr_t> events;
+};
+
+// Separate piles of boxes on one shared ground, with a chain of bodies hanging from the ground.
+static void CreatePiles(b2World& world)
+{
+	b2BodyDef groundDef;
+	b2Body* ground = world.CreateBody(&groundDef);
+
+	b2EdgeShape edge;
+	edge.SetTwoSided(b2Vec2(-200.0f, 0.0f), b2Vec2(200.0f, 0.0f));
+	ground->CreateFixture(&edge, 0.0f);
+
+	b2PolygonShape box;
+	box.SetAsBox(0.5f, 0.5f);
+
+	for (int32 pile = 0; pile < 16; ++pile)
+	{
+		for (int32 i = 0; i < 8; ++i)
+		{
+			b2BodyDef bodyDef;
+			bodyDef.type = b2_dynamicBody;
+			bodyDef.position.Set(-150.0f + 20.0f * pile + 0.1f * i, 0.5f + 1.05f * i);
+			b2Body* body = world.CreateBody(&bodyDef);
+			body->CreateFixture(&box, 1.0f);
+		}
+	}
+
+	b2Body* previous = ground;
+	for (int32 i = 0; i < 10; ++i)
+	{
+		b2BodyDef bodyDef;
+		bodyDef.type = b2_dynamicBody;
+		bodyDef.position.Set(180.0f + 1.0f * i, 20.0f);
+		b2Body* body = world.CreateBody(&bodyDef);
+		body->CreateFixture(&box, 1.0f);
+
+		b2RevoluteJointDef jointDef;
+		jointDef.Initialize(previous, body, b2Vec2(179.5f + 1.0f * i, 20.0f));
+		world.CreateJoint(&jointDef);
+		previous = body;
+	}
+}
+
+DOCTEST_TEST_CASE("parallel islands match serial")
+{
+	b2World serialWorld(b2Vec2(0.0f, -10.0f));
+	b2World parallelWorld(b2Vec2(0.0f, -10.0f));
+
+	CountingListener serialListener;
+	CountingListener parallelListener;
+	serialWorld.SetContactListener(&serialListener);
+	parallelWorld.SetContactListener(&parallelListener);
+
+	ThreadExecutor executor(4);
+	parallelWorld.SetTaskExecutor(&executor);
+	CHECK(parallelWorld.GetTaskExecutor() == &executor);
+
+	CreatePiles(serialWorld);
+	CreatePiles(parallelWorld);
+
+	for (int32 i = 0; i < 120; ++i)
+	{
+		serialWorld.Step(1.0f / 60.0f, 8, 3);
+		parallelWorld.Step(1.0f / 60.0f, 8, 3);
+	}
+
+	CHECK(serialListener.postSolveCount > 0);
+	CHECK(serialListener.postSolveCount == parallelListener.postSolveCount);
+
+	const b2Body* serialBody = serialWorld.GetBodyList();
+	const b2Body* parallelBody = parallelWorld.GetBodyList();
+	while (serialBody != nullptr && parallelBody != nullptr)
+	{
+		CHECK(serialBody->GetPosition().x == parallelBody->GetPosition().x);
+		CHECK(serialBody->GetPosition().y == parallelBody->GetPosition().y);
+		CHECK(serialBody->GetAngle() == parallelBody->GetAngle());
+		CHECK(serialBody->IsAwake() == parallelBody->IsAwake());
+
+		serialBody = serialBody->GetNext();
+		parallelBody = parallelBody->GetNext();
+	}
+	CHECK(serialBody == nullptr);
+	CHECK(parallelBody == nullptr);
+}
+
+
+// Enough circles dropped into a box to make the contact manager compute manifolds in parallel.
+static void CreateDenseScene(b2World& world)
+{
+	b2BodyDef groundDef;
+	b2Body* ground = world.CreateBody(&groundDef);
+
+	b2EdgeShape edge;
+	edge.SetTwoSided(b2Vec2(-20.0f, 0.0f), b2Vec2(20.0f, 0.0f));
+	ground->CreateFixture(&edge, 0.0f);
+	edge.SetTwoSided(b2Vec2(-20.0f, 0.0f), b2Vec2(-20.0f, 60.0f));
+	ground->CreateFixture(&edge, 0.0f);
+	edge.SetTwoSided(b2Vec2(20.0f, 0.0f), b2Vec2(20.0f, 60.0f));
+	ground->CreateFixture(&edge, 0.0f);
+
+	b2CircleShape circle;
+	circle.m_radius = 0.5f;
+
+	for (int32 i = 0; i < 600; ++i)
+	{
+		b2BodyDef bodyDef;
+		bodyDef.type = b2_dynamicBody;
+		bodyDef.position.Set(-19.0f + 1.02f * (i % 38) + 0.01f * (i / 38), 0.5f + 1.02f * (i / 38));
+		bodyDef.userData.pointer = uintptr_t(i + 1);
+		b2Body* body = world.CreateBody(&bodyDef);
+		body->CreateFixture(&circle, 1.0f);
+	}
+}
+
+DOCTEST_TEST_CASE("parallel narrowphase matches serial")
+{
+	b2World serialWorld(b2Vec2(0.0f, -10.0f));
+	b2World parallelWorld(b2Vec2(0.0f, -10.0f));
+
+	RecordingListener serialListener;
+	RecordingListener parallelListener;
+	serialWorld.SetContactListener(&serialListener);
+	parallelWorld.SetContactListener(&parallelListener);
+
+	ThreadExecutor executor(3);
+	parallelWorld.SetTaskExecutor(&executor);
+
+	CreateDenseScene(serialWorld);
+	CreateDenseScene(parallelWorld);
+
+	for (int32 i = 0; i < 90; ++i)
+	{
+		serialWorld.Step(1.0f / 60.0f, 8, 3);
+		parallelWorld.Step(1.0f / 60.0f, 8, 3);
+	}
+
+	CHECK(serialWorld.GetContactCount() > b2_minParallelContacts);
+	CHECK(serialWorld.GetContactCount() == parallelWorld.GetContactCount());
+	CHECK(serialListener.events.empty() == false);
+	CHECK(serialListener.events == parallelListener.events);
+
+	const b2Body* serialBody = serialWorld.GetBodyList();
+	const b2Body* parallelBody = parallelWorld.GetBodyList();
+	bool identical = true;
+	while (serialBody != nullptr && parallelBody != nullptr)
+	{
+		identical = identical && serialBody->GetPosition() == parallelBody->GetPosition();
+		identical = identical && serialBody->GetAngle() == parallelBody->GetAngle();
+
+		serialBody = serialBody->GetNext();
+		parallelBody = parallelBody->GetNext();
+	}
+	CHECK(identical);
+}
@@ -23,6 +23,7 @@
 #include "box2d/box2d.h"
 #include "doctest.h"
 #include <stdio.h>
+#include <string.h>
 
 static bool begin_contact = false;
 
@@ -71,3 +72,158 @@ DOCTEST_TEST_CASE("begin contact")
 	CHECK(world.GetContactList() != nullptr);
 	CHECK(begin_contact == true);
 }
+
+DOCTEST_TEST_CASE("shapes edited in place")
+{
+	b2World world = b2World(b2Vec2(0.0f, 0.0f));
+
+	b2CircleShape circle;
+	circle.m_radius = 1.0f;
+
+	b2BodyDef bodyDef;
+	b2Body* ground = world.CreateBody(&bodyDef);
+	b2Fixture* groundFixture = ground->CreateFixture(&circle, 0.0f);
+
+	bodyDef.type = b2_dynamicBody;
+	bodyDef.position.Set(10.0f, 0.0f);
+	b2Body* body = world.CreateBody(&bodyDef);
+	b2Fixture* fixture = body->CreateFixture(&circle, 1.0f);
+
+	const float timeStep = 1.f / 60.f;
+	world.Step(timeStep, 6, 2);
+	CHECK(world.GetContactCount() == 0);
+
+	float mass = body->GetMass();
+
+	// Grow both circles until they overlap.
+	groundFixture->GetShape()->m_radius = 9.5f;
+	ground->SynchronizeShapes();
+
+	fixture->GetShape()->m_radius = 2.0f;
+	body->SynchronizeShapes();
+
+	CHECK(body->GetMass() == doctest::Approx(4.0f * mass));
+
+	world.Step(timeStep, 6, 2);
+	CHECK(world.GetContactCount() == 1);
+	CHECK(world.GetContactList()->IsTouching());
+}
+
+DOCTEST_TEST_CASE("state save and restore")
+{
+	b2World world = b2World(b2Vec2(0.0f, -10.0f));
+
+	b2BodyDef bodyDef;
+	b2Body* ground = world.CreateBody(&bodyDef);
+
+	b2EdgeShape edge;
+	edge.SetTwoSided(b2Vec2(-40.0f, 0.0f), b2Vec2(40.0f, 0.0f));
+	ground->CreateFixture(&edge, 0.0f);
+
+	b2PolygonShape box;
+	box.SetAsBox(0.5f, 0.5f);
+
+	bodyDef.type = b2_dynamicBody;
+	for (int32 i = 0; i < 10; ++i)
+	{
+		for (int32 j = i; j < 10; ++j)
+		{
+			bodyDef.position.Set(1.1f * j - 0.55f * i - 5.0f, 0.5f + 1.05f * i);
+			world.CreateBody(&bodyDef)->CreateFixture(&box, 1.0f);
+		}
+	}
+
+	// A swinging chain, so joint impulses are part of the state too.
+	b2Body* previous = ground;
+	for (int32 i = 0; i < 5; ++i)
+	{
+		bodyDef.position.Set(10.0f + i, 10.0f);
+		b2Body* link = world.CreateBody(&bodyDef);
+		link->CreateFixture(&box, 1.0f);
+
+		b2RevoluteJointDef jointDef;
+		jointDef.Initialize(previous, link, b2Vec2(9.5f + i, 10.0f));
+		world.CreateJoint(&jointDef);
+		previous = link;
+	}
+
+	const float timeStep = 1.f / 60.f;
+	for (int32 i = 0; i < 30; ++i)
+	{
+		world.Step(timeStep, 6, 2);
+	}
+
+	b2WorldState saved;
+	world.SaveState(&saved);
+	CHECK(saved.GetSize() > 0);
+
+	for (int32 i = 0; i < 60; ++i)
+	{
+		world.Step(timeStep, 6, 2);
+	}
+
+	b2WorldState first;
+	world.SaveState(&first);
+
+	CHECK(world.RestoreState(&saved));
+
+	b2WorldState restored;
+	world.SaveState(&restored);
+	CHECK(restored.GetSize() == saved.GetSize());
+	CHECK(memcmp(restored.GetData(), saved.GetData(), saved.GetSize()) == 0);
+
+	for (int32 i = 0; i < 60; ++i)
+	{
+		world.Step(timeStep, 6, 2);
+	}
+
+	// Stepping again from the restored state lands on exactly the same state.
+	b2WorldState second;
+	world.SaveState(&second);
+	CHECK(second.GetSize() == first.GetSize());
+	CHECK(memcmp(second.GetData(), first.GetData(), first.GetSize()) == 0);
+
+	// A state doesn't restore into a world whose bodies changed since.
+	world.CreateBody(&bodyDef);
+	CHECK(world.RestoreState(&saved) == false);
+}
+
+DOCTEST_TEST_CASE("enable bodies in bulk")
+{
+	b2World world = b2World(b2Vec2(0.0f, -10.0f));
+
+	b2PolygonShape box;
+	box.SetAsBox(0.5f, 0.5f);
+
+	b2BodyDef bodyDef;
+	bodyDef.enabled = false;
+
+	const int32 count = 100;
+	b2Body* bodies[count + 1];
+	for (int32 i = 0; i < count; ++i)
+	{
+		bodyDef.position.Set(float(i), 0.0f);
+		bodies[i] = world.CreateBody(&bodyDef);
+		bodies[i]->CreateFixture(&box, 0.0f);
+	}
+
+	bodyDef.type = b2_dynamicBody;
+	bodyDef.position.Set(10.0f, 0.9f);
+	bodies[count] = world.CreateBody(&bodyDef);
+	bodies[count]->CreateFixture(&box, 1.0f);
+
+	CHECK(world.GetProxyCount() == 0);
+
+	world.EnableBodies(bodies, count + 1);
+	CHECK(world.GetProxyCount() == count + 1);
+
+	for (int32 i = 0; i <= count; ++i)
+	{
+		CHECK(bodies[i]->IsEnabled());
+	}
+
+	// The falling box finds the ground it overlaps on the next step.
+	world.Step(1.0f / 60.0f, 6, 2);
+	CHECK(world.GetContactCount() >= 1);
+	CHECK(world.GetContactList()->IsTouching());
+}
@@ -31,11 +31,20 @@ SOFTWARE.
 
 #include <Ducktape/engine/mathf.h>
 #include <Ducktape/engine/vector2.h>
+#include <Ducktape/engine/matrix3.h>
 #include <Ducktape/engine/dt_time.h>
 #include <Ducktape/engine/color.h>
 #include <Ducktape/engine/debug.h>
 #include <Ducktape/engine/projectsettings.h>
 #include <Ducktape/engine/application.h>
+#include <Ducktape/engine/jobsystem.h>
+#include <Ducktape/engine/commandbuffer.h>
+#include <Ducktape/engine/systems.h>
+#include <Ducktape/engine/typeindex.h>
+#include <Ducktape/engine/archetype.h>
+#include <Ducktape/engine/entityhandle.h>
+#include <Ducktape/engine/name.h>
+#include <Ducktape/engine/transformhierarchy.h>
 
 namespace DT
 {
@@ -46,10 +55,12 @@ namespace DT
 #include <Ducktape/engine/behaviourscript.h>
 #include <Ducktape/engine/transform.h>
 #include <Ducktape/engine/scenemanager.h>
+#include <Ducktape/engine/componentmask.h>
 #include <Ducktape/engine/entity.h>
 #include <Ducktape/engine/input.h>
 #include <Ducktape/rendering/camera.h>
 #include <Ducktape/physics/physics.h>
+#include <Ducktape/physics/queries.h>
 #include <Ducktape/rendering/renderer.h>
 #include <Ducktape/rendering/spriterenderer.h>
 
@@ -64,13 +75,16 @@ namespace DT
 #include <Ducktape/physics/boxcollider.h>
 #include <Ducktape/physics/circlecollider.h>
 #include <Ducktape/physics/edgecollider.h>
+#include <Ducktape/physics/convexdecomposition.h>
 #include <Ducktape/physics/polygoncollider.h>
 #include <Ducktape/engine/scene.h>
 #include <Ducktape/engine/random.h>
 #include <Ducktape/physics/distancejoint.h>
 #include <Ducktape/physics/hingejoint.h>
 #include <Ducktape/physics/frictionjoint.h>
+#ifndef DT_HEADLESS
 #include <Ducktape/audio/audiosource.h>
+#endif
 
 /**
  * @brief Namespace to hold all Ducktape namespaces, classes, functions.
@@ -25,6 +25,8 @@ SOFTWARE.
 #ifndef DUCKTAPE_ENGINE_APPLICATION_H_
 #define DUCKTAPE_ENGINE_APPLICATION_H_
 
+#include <memory>
+
 #include <SFML/Window.hpp>
 #include <SFML/Graphics.hpp>
 
@@ -51,8 +53,15 @@ namespace DT
 		 * @endcond
 		 */
 
+#ifndef DT_HEADLESS
 		extern sf::View view;
-		extern sf::RenderWindow renderWindow;
+
+		/**
+		 * @brief The window the application renders to, created by Application::Initialize() and
+		 * destroyed by Application::Shutdown(). Always empty when running headless.
+		 */
+		extern std::unique_ptr<sf::RenderWindow> renderWindow;
+#endif
 
 		/**
 		 * @brief Set the application's resolution.
@@ -69,10 +78,17 @@ namespace DT
 		Vector2 GetResolution();
 
 		/**
-		 * @brief Initialize the application.
+		 * @brief Initialize the application, opening the window unless running headless.
 		 */
 		void Initialize();
 
+		/**
+		 * @brief Check if the application runs without a window.
+		 *
+		 * @return True if the application runs headless, false otherwise.
+		 */
+		bool IsHeadless();
+
 		/**
 		 * @brief Check if the application is still open.
 		 *
@@ -84,6 +100,11 @@ namespace DT
 		 * @brief Close the application.
 		 */
 		void Close();
+
+		/**
+		 * @brief Destroy the window, once the application has stopped running.
+		 */
+		void Shutdown();
 	}
 }
 
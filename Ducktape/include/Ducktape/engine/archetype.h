@@ -0,0 +1,513 @@
+/*
+MIT License
+
+Copyright (c) 2022 Ducktape
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef DUCKTAPE_ENGINE_ARCHETYPE_H_
+#define DUCKTAPE_ENGINE_ARCHETYPE_H_
+
+#include <algorithm>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <Ducktape/engine/typeindex.h>
+#include <Ducktape/engine/jobsystem.h>
+
+namespace DT
+{
+	/**
+	 * @brief Handle to an entity stored in an ArchetypeStorage.
+	 *
+	 * The generation is bumped every time an index is reused, so a handle to a destroyed entity
+	 * never points to the entity that took its place.
+	 */
+	struct DataEntity
+	{
+		uint32_t index = 0;
+		uint32_t generation = 0;
+
+		bool operator==(const DataEntity &other) const
+		{
+			return index == other.index && generation == other.generation;
+		}
+
+		bool operator!=(const DataEntity &other) const
+		{
+			return !(*this == other);
+		}
+	};
+
+	/**
+	 * @brief The maximum number of different data component types an ArchetypeStorage can hold.
+	 */
+	constexpr size_t MAX_DATA_COMPONENTS = 64;
+
+	/**
+	 * @brief The set of data component types an entity has, one bit per type.
+	 */
+	typedef std::bitset<MAX_DATA_COMPONENTS> ComponentSignature;
+
+	/**
+	 * @brief All the entities that have exactly the same set of data components.
+	 *
+	 * The entities are stored in fixed size chunks, in structure of arrays layout: a chunk holds
+	 * one array per component type, so iterating a component goes through contiguous memory.
+	 * Chunks are always full, except for the last one.
+	 */
+	class Archetype
+	{
+	public:
+		/**
+		 * @brief The size of a chunk, in bytes.
+		 */
+		static constexpr size_t CHUNK_SIZE = 16 * 1024;
+
+		/**
+		 * @brief The alignment of a chunk, in bytes. Enough for cache lines and SIMD loads.
+		 */
+		static constexpr size_t CHUNK_ALIGNMENT = 64;
+
+		/**
+		 * @brief A block of memory holding the components of up to `Archetype::capacity` entities.
+		 */
+		struct Chunk
+		{
+			std::byte *data = nullptr;
+			size_t count = 0;
+		};
+
+		/**
+		 * @brief The component types of the archetype.
+		 */
+		ComponentSignature signature;
+
+		/**
+		 * @brief The chunks of the archetype.
+		 */
+		std::vector<Chunk> chunks;
+
+		/**
+		 * @brief The number of entities a single chunk holds.
+		 */
+		size_t capacity = 0;
+
+		/**
+		 * @brief Create an archetype.
+		 *
+		 * @param signature The component types of the archetype.
+		 * @param typeSizes The size of every component type, indexed by type index.
+		 * @param typeAlignments The alignment of every component type, indexed by type index.
+		 */
+		Archetype(ComponentSignature signature, const std::vector<size_t> &typeSizes, const std::vector<size_t> &typeAlignments);
+		~Archetype();
+
+		Archetype(const Archetype &) = delete;
+		Archetype &operator=(const Archetype &) = delete;
+
+		/**
+		 * @brief Get the array of a component type in a chunk.
+		 *
+		 * @param chunk The chunk to get the array from.
+		 * @param typeIndex The type index of the component type, which has to be in the signature.
+		 * @return void* The start of the array.
+		 */
+		void *GetColumn(const Chunk &chunk, size_t typeIndex) const
+		{
+			return chunk.data + offsets[typeIndex];
+		}
+
+		/**
+		 * @brief Get the array of entity handles in a chunk.
+		 *
+		 * @param chunk The chunk to get the array from.
+		 * @return DataEntity* The start of the array.
+		 */
+		DataEntity *GetEntities(const Chunk &chunk) const
+		{
+			return reinterpret_cast<DataEntity *>(chunk.data);
+		}
+
+		/**
+		 * @brief Add a row at the end of the archetype. The components of the row are left
+		 * uninitialized.
+		 *
+		 * @param entity The entity the row belongs to.
+		 * @return std::pair<size_t, size_t> The chunk and the row in that chunk.
+		 */
+		std::pair<size_t, size_t> PushRow(DataEntity entity);
+
+		/**
+		 * @brief Remove a row by moving the last row of the archetype into its place.
+		 *
+		 * @param chunk The chunk of the row.
+		 * @param row The row in the chunk.
+		 * @return DataEntity The entity that was moved into the removed row, or the removed entity
+		 * itself if it was the last one.
+		 */
+		DataEntity RemoveRow(size_t chunk, size_t row);
+
+		/**
+		 * @brief Get the number of entities in the archetype.
+		 *
+		 * @return size_t The number of entities in the archetype.
+		 */
+		size_t Count() const;
+
+	private:
+		std::vector<size_t> types;
+		std::vector<size_t> offsets;
+		std::vector<size_t> sizes;
+		size_t chunkSize = CHUNK_SIZE;
+	};
+
+	/**
+	 * @brief Archetype based storage for plain data components, next to the BehaviourScript model.
+	 *
+	 * Meant for large numbers of lightweight entities (like particles or bullets) where a
+	 * BehaviourScript per entity is too expensive. Components are plain structs without behaviour,
+	 * entities with the same set of components share an Archetype, and systems work on the
+	 * components by querying for the types they need:
+	 * ```cpp
+	 * struct Position { float x, y; };
+	 * struct Velocity { float x, y; };
+	 *
+	 * ArchetypeStorage &storage = SceneManager::currentScene->archetypes;
+	 * DataEntity bullet = storage.Create(Position{0, 0}, Velocity{10, 0});
+	 *
+	 * storage.Each<Position, Velocity>([](Position &position, Velocity &velocity)
+	 * {
+	 *     position.x += velocity.x * Time::deltaTime;
+	 *     position.y += velocity.y * Time::deltaTime;
+	 * });
+	 * ```
+	 * Components have to be trivially copyable, since they are moved around with memcpy. Entities
+	 * can't be created or destroyed, and components can't be added or removed, while iterating.
+	 */
+	class ArchetypeStorage
+	{
+	public:
+		ArchetypeStorage() = default;
+		ArchetypeStorage(const ArchetypeStorage &) = delete;
+		ArchetypeStorage &operator=(const ArchetypeStorage &) = delete;
+
+		/**
+		 * @brief Create an entity with the given components.
+		 *
+		 * @tparam Ts The component types, all different.
+		 * @param components The components to give the entity.
+		 * @return DataEntity The handle of the created entity.
+		 */
+		template <typename... Ts>
+		DataEntity Create(const Ts &...components)
+		{
+			(RegisterType<Ts>(), ...);
+
+			ComponentSignature signature;
+			(signature.set(TypeIndex<ArchetypeStorage>::Get<Ts>()), ...);
+
+			DataEntity entity = NewEntity();
+			Archetype *archetype = GetArchetype(signature);
+			Place(entity, archetype);
+
+			const Record &record = records[entity.index];
+			const Archetype::Chunk &chunk = archetype->chunks[record.chunk];
+			((static_cast<Ts *>(archetype->GetColumn(chunk, TypeIndex<ArchetypeStorage>::Get<Ts>()))[record.row] = components), ...);
+
+			return entity;
+		}
+
+		/**
+		 * @brief Destroy an entity and its components.
+		 *
+		 * @param entity The entity to destroy.
+		 */
+		void Destroy(DataEntity entity);
+
+		/**
+		 * @brief Check if the entity is still alive.
+		 *
+		 * @param entity The entity to check.
+		 * @return true If the entity is still alive.
+		 * @return false If the entity was destroyed.
+		 */
+		bool IsValid(DataEntity entity) const;
+
+		/**
+		 * @brief Get a component of an entity.
+		 *
+		 * @tparam T The type of the component.
+		 * @param entity The entity to get the component of.
+		 * @return T* The component, or nullptr if the entity doesn't have one or isn't valid.
+		 * The pointer is invalidated when any entity is created, destroyed or changes its components.
+		 */
+		template <typename T>
+		T *Get(DataEntity entity)
+		{
+			if (!IsValid(entity))
+			{
+				return nullptr;
+			}
+
+			const Record &record = records[entity.index];
+			size_t type = TypeIndex<ArchetypeStorage>::Get<T>();
+
+			if (type >= MAX_DATA_COMPONENTS || !record.archetype->signature.test(type))
+			{
+				return nullptr;
+			}
+
+			return static_cast<T *>(record.archetype->GetColumn(record.archetype->chunks[record.chunk], type)) + record.row;
+		}
+
+		/**
+		 * @brief Check if an entity has a component.
+		 *
+		 * @tparam T The type of the component.
+		 * @param entity The entity to check.
+		 * @return true If the entity has a component of type T.
+		 * @return false If the entity doesn't have one, or isn't valid.
+		 */
+		template <typename T>
+		bool Has(DataEntity entity)
+		{
+			return Get<T>(entity) != nullptr;
+		}
+
+		/**
+		 * @brief Add a component to an entity, moving it to the archetype for its new set of
+		 * components. Overwrites the component if the entity already has one.
+		 *
+		 * @tparam T The type of the component.
+		 * @param entity The entity to add the component to.
+		 * @param component The component to add.
+		 */
+		template <typename T>
+		void Add(DataEntity entity, const T &component)
+		{
+			if (!IsValid(entity))
+			{
+				return;
+			}
+
+			RegisterType<T>();
+
+			ComponentSignature signature = records[entity.index].archetype->signature;
+			signature.set(TypeIndex<ArchetypeStorage>::Get<T>());
+			Move(entity, signature);
+
+			*Get<T>(entity) = component;
+		}
+
+		/**
+		 * @brief Remove a component from an entity, moving it to the archetype for its new set of
+		 * components.
+		 *
+		 * @tparam T The type of the component.
+		 * @param entity The entity to remove the component from.
+		 */
+		template <typename T>
+		void Remove(DataEntity entity)
+		{
+			if (!Has<T>(entity))
+			{
+				return;
+			}
+
+			ComponentSignature signature = records[entity.index].archetype->signature;
+			signature.reset(TypeIndex<ArchetypeStorage>::Get<T>());
+			Move(entity, signature);
+		}
+
+		/**
+		 * @brief Call a function for every chunk of every entity that has all of the given
+		 * components. Suited for loops the compiler can vectorize.
+		 *
+		 * @tparam Ts The component types to query.
+		 * @param func The function to call, with the number of entities in the chunk and a pointer
+		 * to the array of every queried component type: `func(size_t count, Ts *...arrays)`.
+		 */
+		template <typename... Ts, typename Func>
+		void EachChunk(Func func)
+		{
+			ComponentSignature signature;
+			if (!GetQuerySignature<Ts...>(signature))
+			{
+				return;
+			}
+
+			for (const std::unique_ptr<Archetype> &archetype : archetypes)
+			{
+				if ((archetype->signature & signature) != signature)
+				{
+					continue;
+				}
+
+				for (const Archetype::Chunk &chunk : archetype->chunks)
+				{
+					func(chunk.count, static_cast<Ts *>(archetype->GetColumn(chunk, TypeIndex<ArchetypeStorage>::Get<Ts>()))...);
+				}
+			}
+		}
+
+		/**
+		 * @brief Call a function for every entity that has all of the given components.
+		 *
+		 * @tparam Ts The component types to query.
+		 * @param func The function to call, with a reference to each queried component:
+		 * `func(Ts &...components)`.
+		 */
+		template <typename... Ts, typename Func>
+		void Each(Func func)
+		{
+			EachChunk<Ts...>([&func](size_t count, Ts *...columns)
+			{
+				for (size_t i = 0; i < count; i++)
+				{
+					func(columns[i]...);
+				}
+			});
+		}
+
+		/**
+		 * @brief Same as ArchetypeStorage::Each, but the chunks are spread over the JobSystem's
+		 * worker threads. The function must be safe to run for different entities at the same time.
+		 *
+		 * @tparam Ts The component types to query.
+		 * @param func The function to call, with a reference to each queried component:
+		 * `func(Ts &...components)`.
+		 */
+		template <typename... Ts, typename Func>
+		void ParallelEach(Func func)
+		{
+			ComponentSignature signature;
+			if (!GetQuerySignature<Ts...>(signature))
+			{
+				return;
+			}
+
+			std::vector<std::pair<const Archetype *, const Archetype::Chunk *>> matches;
+			for (const std::unique_ptr<Archetype> &archetype : archetypes)
+			{
+				if ((archetype->signature & signature) != signature)
+				{
+					continue;
+				}
+
+				for (const Archetype::Chunk &chunk : archetype->chunks)
+				{
+					matches.push_back({archetype.get(), &chunk});
+				}
+			}
+
+			JobSystem::ParallelFor(matches.size(), 1, [&](size_t begin, size_t end)
+			{
+				for (size_t m = begin; m < end; m++)
+				{
+					const Archetype *archetype = matches[m].first;
+					const Archetype::Chunk &chunk = *matches[m].second;
+
+					auto run = [&func](size_t count, Ts *...columns)
+					{
+						for (size_t i = 0; i < count; i++)
+						{
+							func(columns[i]...);
+						}
+					};
+					run(chunk.count, static_cast<Ts *>(archetype->GetColumn(chunk, TypeIndex<ArchetypeStorage>::Get<Ts>()))...);
+				}
+			});
+		}
+
+		/**
+		 * @brief Get the number of alive entities.
+		 *
+		 * @return size_t The number of alive entities.
+		 */
+		size_t Count() const;
+
+		/**
+		 * @brief Destroy every entity, and free all the chunks.
+		 */
+		void Clear();
+
+	private:
+		struct Record
+		{
+			Archetype *archetype = nullptr;
+			size_t chunk = 0;
+			size_t row = 0;
+			uint32_t generation = 0;
+		};
+
+		std::vector<Record> records;
+		std::vector<uint32_t> freeIndices;
+		std::vector<std::unique_ptr<Archetype>> archetypes;
+		std::unordered_map<ComponentSignature, Archetype *> archetypeMap;
+		std::vector<size_t> sizes = std::vector<size_t>(MAX_DATA_COMPONENTS, 0);
+		std::vector<size_t> alignments = std::vector<size_t>(MAX_DATA_COMPONENTS, 0);
+
+		template <typename T>
+		void RegisterType()
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "Data components have to be trivially copyable.");
+			static_assert(alignof(T) <= Archetype::CHUNK_ALIGNMENT, "Data components can't be aligned to more than a chunk.");
+
+			size_t type = TypeIndex<ArchetypeStorage>::Get<T>();
+			RegisterType(type, sizeof(T), alignof(T));
+		}
+
+		template <typename... Ts>
+		bool GetQuerySignature(ComponentSignature &signature) const
+		{
+			size_t types[] = {TypeIndex<ArchetypeStorage>::Get<Ts>()...};
+			for (size_t type : types)
+			{
+				// A type that was never registered can't be in any archetype.
+				if (type >= MAX_DATA_COMPONENTS || sizes[type] == 0)
+				{
+					return false;
+				}
+
+				signature.set(type);
+			}
+			return true;
+		}
+
+		void RegisterType(size_t type, size_t size, size_t alignment);
+		DataEntity NewEntity();
+		Archetype *GetArchetype(ComponentSignature signature);
+		void Place(DataEntity entity, Archetype *archetype);
+		void Move(DataEntity entity, ComponentSignature signature);
+		void RemoveFromArchetype(DataEntity entity);
+	};
+}
+
+#endif
@@ -33,11 +33,12 @@ SOFTWARE.
 namespace DT
 {
     class Entity;
+    class TickList;
 
     /**
      * @brief Base class for components that are to be attached to entities.
      *
-     * Components are essentially what add scripting functionality to the engine. You may attach any number of components to an entity. Components are executed in the order of attachment.
+     * Components are essentially what add scripting functionality to the engine. You may attach any number of components to an entity. Components are ticked type by type, in the order each type was first attached to an entity, and in the order of attachment within a type. Types that don't override `Tick()` are never visited by the tick loop.
 
      * Scripting a component is done by creating a class that inherits from the `BehaviourScript` like:
      * ```cpp
@@ -107,6 +108,42 @@ namespace DT
          */
         bool isDestroyed = false;
 
+        /**
+         * @brief Declares if components of this type may be ticked on worker threads.
+         *
+         * Components whose `Tick()` only touches their own data (and no physics, rendering or other
+         * entities) can hide this with `static constexpr bool parallelSafe = true;`. They are then
+         * ticked in parallel, before the other tick lists, when ProjectSettings::JobSystem::parallelTicks
+         * is enabled.
+         */
+        static constexpr bool parallelSafe = false;
+
+        /**
+         * @brief If this component is sent collision events, set by Entity::AddComponent() when its
+         * type overrides `OnCollisionEnter()` or `OnCollisionExit()`.
+         */
+        bool receivesCollisions = false;
+
+        /**
+         * @brief The tick list this component is registered in, nullptr if its type doesn't override Tick().
+         */
+        TickList *tickList = nullptr;
+
+        /**
+         * @brief The index of this component in its tick list.
+         */
+        size_t tickIndex = 0;
+
+        /**
+         * @brief The ComponentType::Index() of this component's type.
+         */
+        size_t typeIndex = 0;
+
+        /**
+         * @brief Gives this component back to the pool of its type, set by Entity::AddComponent().
+         */
+        void (*release)(BehaviourScript *) = nullptr;
+
         /**
          * @brief Called when the component is added to an entity.
          *
@@ -127,6 +164,9 @@ namespace DT
         /**
          * @brief Triggered when the Rigidbody attached to this component enters a collision.
          *
+         * Collision events are queued while the physics world steps, and delivered after it,
+         * so it's safe to create or destroy bodies from here.
+         *
          * @param collider Collider containing information about the collision.
          */
         virtual void OnCollisionEnter(Collision collider) {}
@@ -161,10 +201,17 @@ namespace DT
         virtual void OnDestroy() {}
 
         /**
-         * @brief Destroy this component.
+         * @brief Destroy this component. During the frame, this is recorded in the CommandBuffer
+         * and applied at its end.
          */
         void Destroy();
 
+        /**
+         * @brief Destroy this component right away. Not safe while components are ticking or
+         * physics is stepping, use BehaviourScript::Destroy() there instead.
+         */
+        void DestroyImmediate();
+
         /**
          * @brief Triggered when application is closed.
          */
@@ -190,7 +190,9 @@ namespace DT
 
 		Color(int r, int b, int g, int a);
 
+#ifndef DT_HEADLESS
 		operator sf::Color() const;
+#endif
 
 		/**
 		 * @brief Lerp between two colors
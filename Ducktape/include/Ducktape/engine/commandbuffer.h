@@ -0,0 +1,106 @@
+/*
+MIT License
+
+Copyright (c) 2022 Ducktape
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef DUCKTAPE_ENGINE_COMMANDBUFFER_H_
+#define DUCKTAPE_ENGINE_COMMANDBUFFER_H_
+
+#include <vector>
+
+namespace DT
+{
+	class Entity;
+	class BehaviourScript;
+	class TickList;
+
+	/**
+	 * @brief Queue of structural changes (destroying entities and components, and adding
+	 * components to the tick lists) made while the frame is running.
+	 *
+	 * While the engine is ticking components and stepping physics, the lists it iterates must not
+	 * change under it, and Box2D doesn't allow bodies to be destroyed inside contact callbacks.
+	 * So during that time, `Entity::Destroy()`, `BehaviourScript::Destroy()`,
+	 * `Entity::RemoveComponent()` and the tick registration of `Entity::AddComponent()` are recorded
+	 * here instead, and applied in the order they were made by CommandBuffer::Flush() at the end
+	 * of the frame. Destroyed objects stay valid until then.
+	 *
+	 * Recording is thread-safe, so `parallelSafe` components may destroy entities and components.
+	 */
+	namespace CommandBuffer
+	{
+		/**
+		 * @brief The kinds of structural changes that can be recorded.
+		 */
+		enum class CommandType
+		{
+			RegisterComponent,
+			RemoveComponent,
+			DestroyComponent,
+			DestroyEntity
+		};
+
+		/**
+		 * @brief A recorded structural change.
+		 */
+		struct Command
+		{
+			CommandType type;
+			Entity *entity = nullptr;
+			BehaviourScript *component = nullptr;
+			TickList *tickList = nullptr;
+		};
+
+		/**
+		 * @brief Check if structural changes are being recorded instead of applied right away.
+		 *
+		 * @return true If changes are being recorded.
+		 * @return false If changes are applied right away.
+		 */
+		bool IsRecording();
+
+		/**
+		 * @brief Start recording structural changes, called by the engine at the start of the frame.
+		 */
+		void Begin();
+
+		/**
+		 * @brief Record a structural change, to be applied by CommandBuffer::Flush().
+		 *
+		 * @param command The change to record.
+		 */
+		void Record(const Command &command);
+
+		/**
+		 * @brief Stop recording, apply every recorded change in order, and compact the tick lists
+		 * in a single pass. Called by the engine at the end of the frame.
+		 */
+		void Flush();
+
+		/**
+		 * @brief Drop every recorded change without applying it, used when a scene is unloaded.
+		 */
+		void Clear();
+	}
+}
+
+#endif
@@ -0,0 +1,192 @@
+/*
+MIT License
+
+Copyright (c) 2022 Ducktape
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef DUCKTAPE_ENGINE_COMPONENTMASK_H_
+#define DUCKTAPE_ENGINE_COMPONENTMASK_H_
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <Ducktape/engine/behaviourscript.h>
+#include <Ducktape/engine/typeindex.h>
+#include <Ducktape/engine/debug.h>
+
+namespace DT
+{
+	/**
+	 * @brief The maximum number of different component types.
+	 */
+	constexpr size_t MAX_COMPONENTS = 128;
+
+	/**
+	 * @brief A set of component types, one bit per component type index.
+	 */
+	struct ComponentMask
+	{
+		static constexpr size_t WORDS = MAX_COMPONENTS / 64;
+
+		uint64_t words[WORDS] = {};
+
+		void Set(size_t type)
+		{
+			words[type / 64] |= uint64_t(1) << (type % 64);
+		}
+
+		void Reset(size_t type)
+		{
+			words[type / 64] &= ~(uint64_t(1) << (type % 64));
+		}
+
+		bool Test(size_t type) const
+		{
+			return (words[type / 64] >> (type % 64)) & 1;
+		}
+
+		/**
+		 * @brief Get the lowest type index in the set.
+		 *
+		 * @return size_t The lowest type index in the set, MAX_COMPONENTS if the set is empty.
+		 */
+		size_t First() const
+		{
+			for (size_t i = 0; i < WORDS; i++)
+			{
+				if (words[i] != 0)
+				{
+					return i * 64 + std::countr_zero(words[i]);
+				}
+			}
+			return MAX_COMPONENTS;
+		}
+
+		/**
+		 * @brief Get the number of type indices in the set.
+		 *
+		 * @return size_t The number of type indices in the set.
+		 */
+		size_t Count() const
+		{
+			size_t count = 0;
+			for (size_t i = 0; i < WORDS; i++)
+			{
+				count += std::popcount(words[i]);
+			}
+			return count;
+		}
+	};
+
+	/**
+	 * @brief Type information for a component type, used by Entity to find components without RTTI.
+	 *
+	 * @tparam T The component type, or any class components may derive from.
+	 */
+	template <typename T>
+	class ComponentType
+	{
+	public:
+		/**
+		 * @brief Get the index of the component type, the same for the whole run of the program.
+		 *
+		 * @return size_t The index of the component type.
+		 */
+		static size_t Index()
+		{
+			static const size_t index = Register();
+			return index;
+		}
+
+		/**
+		 * @brief Cast a component to T.
+		 *
+		 * @param component The component, which has to be a T.
+		 * @return T* The component as a T.
+		 */
+		static T *Cast(BehaviourScript *component)
+		{
+			if constexpr (std::is_base_of_v<BehaviourScript, T>)
+			{
+				return static_cast<T *>(component);
+			}
+			else
+			{
+				return dynamic_cast<T *>(component);
+			}
+		}
+
+		/**
+		 * @brief Get the component types in a mask that are T or derive from T.
+		 *
+		 * Whether a type derives from T is worked out with a dynamic_cast the first time that type
+		 * is seen with T, and remembered for every lookup after that.
+		 *
+		 * @param mask The component types to check.
+		 * @param slots A component of every type in the mask, indexed by type index.
+		 * @return ComponentMask The types in the mask that are T or derive from T.
+		 */
+		static ComponentMask Match(const ComponentMask &mask, const std::vector<BehaviourScript *> &slots)
+		{
+			ComponentMask result;
+			for (size_t i = 0; i < ComponentMask::WORDS; i++)
+			{
+				uint64_t unknown = mask.words[i] & ~classified[i].load(std::memory_order_acquire);
+				while (unknown != 0)
+				{
+					size_t type = i * 64 + std::countr_zero(unknown);
+					unknown &= unknown - 1;
+
+					uint64_t bit = uint64_t(1) << (type % 64);
+					if (dynamic_cast<T *>(slots[type]) != nullptr)
+					{
+						derived[i].fetch_or(bit, std::memory_order_relaxed);
+					}
+					classified[i].fetch_or(bit, std::memory_order_release);
+				}
+
+				result.words[i] = mask.words[i] & derived[i].load(std::memory_order_relaxed);
+			}
+			return result;
+		}
+
+	private:
+		inline static std::atomic<uint64_t> classified[ComponentMask::WORDS] = {};
+		inline static std::atomic<uint64_t> derived[ComponentMask::WORDS] = {};
+
+		static size_t Register()
+		{
+			size_t index = TypeIndex<BehaviourScript>::Get<T>();
+			if (index >= MAX_COMPONENTS)
+			{
+				Debug::LogFatalError("Too many component types, the maximum is " + std::to_string(MAX_COMPONENTS) + ".");
+			}
+			return index;
+		}
+	};
+}
+
+#endif
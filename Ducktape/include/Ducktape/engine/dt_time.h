@@ -35,9 +35,18 @@ namespace DT
 	namespace Time
 	{
 		/**
-		 * @brief Time passed since the last frame in seconds.
+		 * @brief Time passed since the last frame in seconds. Always
+		 * ProjectSettings::Physics::fixedDeltaTime when running headless.
 		 */
 		extern float deltaTime;
+
+		/**
+		 * @brief How far (0 to 1) the current frame is between the last two fixed physics steps.
+		 * Used to interpolate rendered transforms when ProjectSettings::Physics::fixedTimestep
+		 * is enabled, it's always 1 otherwise.
+		 */
+		extern float interpolationAlpha;
+
 		extern sf::Clock clock;
 		extern sf::Clock deltaClock;
 
@@ -26,13 +26,19 @@ SOFTWARE.
 #define DUCKTAPE_ENGINE_ENTITY_H_
 
 #include <string>
+#include <string_view>
 #include <vector>
-#include <typeinfo>
+#include <type_traits>
 
 #include <Ducktape/engine/behaviourscript.h>
 #include <Ducktape/engine/scenemanager.h>
 #include <Ducktape/engine/transform.h>
 #include <Ducktape/engine/memory.h>
+#include <Ducktape/engine/systems.h>
+#include <Ducktape/engine/componentmask.h>
+#include <Ducktape/engine/entityhandle.h>
+#include <Ducktape/engine/name.h>
+#include <Ducktape/engine/commandbuffer.h>
 
 namespace DT
 {
@@ -63,20 +69,42 @@ namespace DT
          */
         bool isEnabled = true;
 
-        /**
-         * @brief The name of the entity.
-         */
-        std::string name = "New Entity";
 
         /**
          * @brief The list of components attached to this entity.
          */
         std::vector<BehaviourScript *> components;
 
+        /**
+         * @brief The component types attached to this entity, indexed by ComponentType::Index().
+         */
+        ComponentMask componentMask;
+
+        /**
+         * @brief The first attached component of every type in Entity::componentMask, indexed by
+         * ComponentType::Index().
+         */
+        std::vector<BehaviourScript *> componentSlots;
+
         /**
          * @brief The scene that this entity belongs to.
          */
-        Scene *scene;
+        Scene *scene = nullptr;
+
+        /**
+         * @brief The handle of this entity, which stays checkable after the entity is destroyed.
+         */
+        EntityHandle handle;
+
+        /**
+         * @brief The index of this entity in Scene::entities.
+         */
+        size_t sceneIndex = 0;
+
+        /**
+         * @brief The index of this entity among the entities of the scene with the same name.
+         */
+        size_t nameIndex = 0;
 
         /**
          * @brief Adds a component to the entity.
@@ -87,17 +115,30 @@ namespace DT
         template <typename T>
         T *AddComponent()
         {
-            T *component = new T();
+            T *component = Memory::GetPool<T>().New();
             component->entity = this;
+            component->receivesCollisions = Systems::overridesCollision<T>;
+            component->typeIndex = ComponentType<T>::Index();
+            component->release = [](BehaviourScript *released)
+            {
+                Memory::GetPool<T>().Delete(static_cast<T *>(released));
+            };
             component->Constructor();
             this->components.push_back(component);
-            Memory::heapMemory.push_back(component);
+            AddToSlots(component);
+            Systems::Register(component);
             return component;
         }
 
         /**
          * @brief Gets a component from the entity.
          *
+         * A component of exactly type T is found in constant time, from the slot of its type index.
+         * The index is handed out the first time the type is used, not at compile time. Otherwise
+         * the first attached component deriving from T is returned, so lookups by base class keep
+         * working. When a single attached type derives from T that is a constant time lookup too,
+         * only when several do are the components searched in the order they were attached.
+         *
          * @tparam T The type of component to get.
          * @return T* Pointer to the component that was found, if component is
          * not attached to entity, nullptr is returned.
@@ -105,36 +146,71 @@ namespace DT
         template <typename T>
         T *GetComponent()
         {
-            for (auto script : this->components)
+            size_t type = ComponentType<T>::Index();
+            if (componentMask.Test(type))
+            {
+                return ComponentType<T>::Cast(componentSlots[type]);
+            }
+
+            if constexpr (std::is_final_v<T>)
+            {
+                return nullptr;
+            }
+            else
             {
-                if (T *ptr = dynamic_cast<T *>(script))
+                ComponentMask matches = ComponentType<T>::Match(componentMask, componentSlots);
+                size_t match = matches.First();
+                if (match == MAX_COMPONENTS)
+                {
+                    return nullptr;
+                }
+
+                if (matches.Count() == 1)
                 {
-                    return ptr;
+                    return ComponentType<T>::Cast(componentSlots[match]);
                 }
+
+                for (BehaviourScript *component : components)
+                {
+                    if (matches.Test(component->typeIndex))
+                    {
+                        return ComponentType<T>::Cast(component);
+                    }
+                }
+                return nullptr;
             }
-            return nullptr;
+        }
+
+        /**
+         * @brief Checks if the entity has a component.
+         *
+         * @tparam T The type of component to check for.
+         * @return If a component of type T, or deriving from T, is attached to the entity.
+         */
+        template <typename T>
+        bool HasComponent()
+        {
+            return GetComponent<T>() != nullptr;
         }
 
         /**
          * @brief Removes a component from the entity.
          *
+         * The component is found like Entity::GetComponent() does, but removing it is linear in the
+         * number of components attached, which keeps Entity::components in attachment order.
+         *
          * @tparam T The type of component to remove.
          * @return If the component was successfully removed.
          */
         template <typename T>
         bool RemoveComponent()
         {
-            int i = 0;
-            for (auto script : this->components)
+            T *component = GetComponent<T>();
+            if (component == nullptr)
             {
-                if (T *ptr = dynamic_cast<T *>(script))
-                {
-                    this->components.erase(this->components.begin() + i);
-                    return true;
-                }
-                i++;
+                return false;
             }
-            return false;
+            return RemoveComponent(component);
         }
 
         /**
@@ -142,16 +218,64 @@ namespace DT
          *
          * Could be used to remove a specific component from the entity, if
          * multiple components of the same type are attached to the entity.
+         * During the frame, the removal is recorded in the CommandBuffer and applied at its end.
          */
         bool RemoveComponent(BehaviourScript *check);
 
         /**
-         * @brief Finds an Entity in the current scene by name.
+         * @brief Remove a component right away. Not safe while components are ticking or physics
+         * is stepping, use Entity::RemoveComponent() there instead. Linear in the number of
+         * components attached.
+         */
+        bool RemoveComponentImmediate(BehaviourScript *check);
+
+        /**
+         * @brief Get the name of the entity.
+         *
+         * @return `const std::string&` The name of the entity.
+         */
+        const std::string &GetName() const;
+
+        /**
+         * @brief Set the name of the entity, keeping the name index of its scene up to date.
+         *
+         * @param newName The new name of the entity.
+         */
+        void SetName(std::string_view newName);
+
+        /**
+         * @brief Finds an Entity in the current scene by name, in constant time and without
+         * allocating.
          *
          * @param entityName
-         * @return `Entity*` Pointer to the entity that was found, nullptr if no entity was found.
+         * @return `Entity*` Pointer to one of the entities with that name, nullptr if no entity was found.
          */
-        static Entity *Find(std::string entityName);
+        static Entity *Find(std::string_view entityName);
+
+        /**
+         * @brief Finds every Entity in the current scene with a name.
+         *
+         * @param entityName
+         * @return `const std::vector<Entity*>&` The entities with that name, in no particular order.
+         * Only valid until an entity is created, destroyed or renamed.
+         */
+        static const std::vector<Entity *> &FindAll(std::string_view entityName);
+
+        /**
+         * @brief Gets the entity a handle refers to, in the current scene.
+         *
+         * @param handle The handle of the entity.
+         * @return `Entity*` Pointer to the entity, nullptr if it was destroyed.
+         */
+        static Entity *Get(EntityHandle handle);
+
+        /**
+         * @brief Checks if a handle refers to an entity that is still alive in the current scene.
+         *
+         * @param handle The handle to check.
+         * @return If the entity is still alive.
+         */
+        static bool IsValid(EntityHandle handle);
 
         /**
          * @brief Creates a new entity in the current scene.
@@ -171,7 +295,7 @@ namespace DT
          * @brief Creates a new entity in the current scene.
          *
          * @param pos Position of the entity.
-         * @param rot Rotation of the entity.
+         * @param rot Rotation of the entity, in radians.
          * @param scl Scale of the entity.
          * @return `Entity*` Pointer to the entity that was created.
          */
@@ -182,23 +306,41 @@ namespace DT
          *
          * @param entityName The name of the entity.
          * @param pos Position of the entity.
-         * @param rot Rotation of the entity.
+         * @param rot Rotation of the entity, in radians.
          * @param scl Scale of the entity.
          * @return `Entity*` Pointer to the entity that was created.
          */
         static Entity *Instantiate(std::string entityName, Vector2 pos, float rot, Vector2 scl);
 
         /**
-         * @brief Destroy the entity.
+         * @brief Destroy the entity and all of its components. During the frame, this is recorded
+         * in the CommandBuffer and applied at its end. The memory of the entity and its components
+         * goes back to their pools at the end of the frame.
          */
         void Destroy();
 
+        /**
+         * @brief Destroy the entity and all of its components right away. Not safe while
+         * components are ticking or physics is stepping, use Entity::Destroy() there instead.
+         */
+        void DestroyImmediate();
+
         /**
          * @brief Enable/Disable the entity.
          *
          * @param isEnabled If the entity should be enabled or not.
          */
         void SetEnabled(bool isEnabled);
+
+    private:
+        friend class Scene;
+
+        /**
+         * @brief The name of the entity, set with Entity::SetName().
+         */
+        Name name = Name("New Entity");
+
+        void AddToSlots(BehaviourScript *component);
     };
 
     /**
@@ -206,9 +348,27 @@ namespace DT
      */
     inline void BehaviourScript::Destroy()
     {
-        this->OnDestroy();
-        entity->RemoveComponent(this);
+        if (CommandBuffer::IsRecording())
+        {
+            CommandBuffer::Record({CommandBuffer::CommandType::DestroyComponent, entity, this});
+            return;
+        }
+        DestroyImmediate();
+    }
+
+    /**
+     * @brief Destroy a component right away.
+     */
+    inline void BehaviourScript::DestroyImmediate()
+    {
+        if (this->isDestroyed)
+        {
+            return;
+        }
         this->isDestroyed = true;
+        this->OnDestroy();
+        entity->RemoveComponentImmediate(this);
+        Memory::ReleaseComponent(this);
     }
 }
 
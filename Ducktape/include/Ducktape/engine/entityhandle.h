@@ -0,0 +1,73 @@
+/*
+MIT License
+
+Copyright (c) 2022 Ducktape
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef DUCKTAPE_ENGINE_ENTITYHANDLE_H_
+#define DUCKTAPE_ENGINE_ENTITYHANDLE_H_
+
+#include <cstdint>
+
+namespace DT
+{
+	/**
+	 * @brief A reference to an Entity that can be checked for validity, unlike a raw `Entity *`.
+	 *
+	 * A handle is an index into the entity table of a Scene, along with the generation of that
+	 * index when the handle was made. The generation is bumped when the entity is destroyed, so
+	 * handles to destroyed entities are detected with a single comparison, even after their
+	 * index and memory have been reused by a new entity.
+	 *
+	 * Example:
+	 * ```cpp
+	 * EntityHandle target = enemy->handle;
+	 *
+	 * // Some frames later
+	 * if (Entity *entity = Entity::Get(target))
+	 * {
+	 *     // The enemy is still alive
+	 * }
+	 * ```
+	 */
+	struct EntityHandle
+	{
+		uint32_t index = 0;
+
+		/**
+		 * @brief The generation of the index, 0 is never used by a live entity so default
+		 * constructed handles are always invalid.
+		 */
+		uint32_t generation = 0;
+
+		bool operator==(const EntityHandle &other) const
+		{
+			return index == other.index && generation == other.generation;
+		}
+
+		bool operator!=(const EntityHandle &other) const
+		{
+			return !(*this == other);
+		}
+	};
+}
+
+#endif
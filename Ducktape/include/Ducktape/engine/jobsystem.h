@@ -0,0 +1,83 @@
+/*
+MIT License
+
+Copyright (c) 2022 Ducktape
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef DUCKTAPE_ENGINE_JOBSYSTEM_H_
+#define DUCKTAPE_ENGINE_JOBSYSTEM_H_
+
+#include <cstddef>
+#include <functional>
+
+namespace DT
+{
+	/**
+	 * @brief A work-stealing thread pool owned by the engine, used to spread work over all cores.
+	 *
+	 * Every worker thread has its own queue of jobs. Workers take jobs from the back of their own
+	 * queue, and when it runs dry they steal from the front of another worker's queue, so the load
+	 * stays balanced even when some jobs take a lot longer than others.
+	 */
+	namespace JobSystem
+	{
+		/**
+		 * @brief Start the worker threads.
+		 *
+		 * @param workerCount The number of worker threads to start, 0 to start one less than the
+		 * number of hardware threads (the thread calling JobSystem::ParallelFor works too).
+		 */
+		void Init(unsigned int workerCount);
+
+		/**
+		 * @brief Stop and join all the worker threads.
+		 */
+		void Shutdown();
+
+		/**
+		 * @brief Get the number of worker threads running.
+		 *
+		 * @return unsigned int The number of worker threads running.
+		 */
+		unsigned int GetWorkerCount();
+
+		/**
+		 * @brief Get the index of the calling thread, 1 to the worker count for the worker threads
+		 * and 0 for any other thread.
+		 *
+		 * @return unsigned int The index of the calling thread.
+		 */
+		unsigned int GetThreadIndex();
+
+		/**
+		 * @brief Split the range [0, count) into chunks and run func on every chunk across the
+		 * worker threads. The calling thread helps out, and the function only returns once every
+		 * chunk is done.
+		 *
+		 * @param count The number of items to process.
+		 * @param chunkSize The maximum number of items processed by a single job.
+		 * @param func The function to run, called with the [begin, end) range of a chunk.
+		 */
+		void ParallelFor(size_t count, size_t chunkSize, const std::function<void(size_t, size_t)> &func);
+	}
+}
+
+#endif
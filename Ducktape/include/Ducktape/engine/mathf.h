@@ -114,6 +114,7 @@ namespace DT
 
         /**
          * @brief Returns the shortest difference between two given angles given in degrees.
+         * Transform rotations are in radians, convert them with Mathf::Rad2Deg first.
          * @param value The first angle in degrees.
          * @param value2 The second angle in degrees.
          * @return The shortest difference between two given angles given in degrees.
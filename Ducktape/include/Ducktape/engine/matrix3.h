@@ -0,0 +1,94 @@
+/*
+MIT License
+
+Copyright (c) 2022 Ducktape
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef DUCKTAPE_ENGINE_MATRIX3_H_
+#define DUCKTAPE_ENGINE_MATRIX3_H_
+
+#include <Ducktape/engine/vector2.h>
+
+namespace DT
+{
+    /**
+     * @brief A 3x3 matrix for 2D affine transformations (translation, rotation and scale).
+     *
+     * Points are treated as column vectors `(x, y, 1)`, so `a * b` applies `b` first, then `a`.
+     */
+    class Matrix3
+    {
+    public:
+        /**
+         * @brief The elements of the matrix, as m[row][column].
+         */
+        float m[3][3];
+
+        /**
+         * @brief Construct an identity matrix.
+         */
+        Matrix3();
+
+        /**
+         * @brief Construct the matrix that scales, then rotates, then translates.
+         *
+         * @param translation The translation.
+         * @param rotation The rotation, in radians.
+         * @param scale The scale.
+         * @return Matrix3 The transformation matrix.
+         */
+        static Matrix3 TRS(Vector2 translation, float rotation, Vector2 scale);
+
+        Matrix3 operator*(const Matrix3 &other) const;
+
+        /**
+         * @brief Transform a point, applying translation.
+         *
+         * @param point The point to transform.
+         * @return Vector2 The transformed point.
+         */
+        Vector2 TransformPoint(Vector2 point) const;
+
+        /**
+         * @brief Transform a direction, ignoring translation.
+         *
+         * @param direction The direction to transform.
+         * @return Vector2 The transformed direction.
+         */
+        Vector2 TransformDirection(Vector2 direction) const;
+
+        /**
+         * @brief Get the inverse of the matrix, which has to be affine and not singular.
+         *
+         * @return Matrix3 The inverse of the matrix.
+         */
+        Matrix3 Inverse() const;
+
+        /**
+         * @brief Get the translation part of the matrix.
+         *
+         * @return Vector2 The translation of the matrix.
+         */
+        Vector2 GetTranslation() const;
+    };
+}
+
+#endif
@@ -25,6 +25,10 @@ SOFTWARE.
 #ifndef DUCKTAPE_ENGINE_MEMORY_H_
 #define DUCKTAPE_ENGINE_MEMORY_H_
 
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
 #include <vector>
 
 #include <Ducktape/engine/behaviourscript.h>
@@ -37,7 +41,277 @@ namespace DT
 	 */
 	namespace Memory
 	{
-		extern std::vector<void *> heapMemory;
+		/**
+		 * @brief Base class of all pools, so the engine can clear them without knowing their type.
+		 */
+		class PoolBase
+		{
+		public:
+			virtual ~PoolBase() = default;
+
+			/**
+			 * @brief Destroy every object in the pool, keeping the memory for reuse.
+			 */
+			virtual void Clear() = 0;
+		};
+
+		/**
+		 * @brief Every pool created by Memory::GetPool().
+		 */
+		extern std::vector<PoolBase *> pools;
+
+		/**
+		 * @brief A slab allocator for objects of a single type.
+		 *
+		 * Objects are constructed in slabs of memory that are never given back to the system while
+		 * the program runs. Deleted objects go on a free list, and the next Pool::New() reuses them,
+		 * so creating and destroying objects doesn't go through malloc at all once the pool is warm.
+		 *
+		 * @tparam T The type of the objects.
+		 */
+		template <typename T>
+		class Pool : public PoolBase
+		{
+		public:
+			/**
+			 * @brief The number of objects in a slab created when the pool runs out of space.
+			 */
+			static constexpr size_t SLAB_OBJECTS = std::max<size_t>(16 * 1024 / sizeof(T), 8);
+
+			Pool() = default;
+			Pool(const Pool &) = delete;
+			Pool &operator=(const Pool &) = delete;
+
+			~Pool()
+			{
+				Clear();
+			}
+
+			/**
+			 * @brief Construct an object in the pool.
+			 *
+			 * @return T* The new object.
+			 */
+			T *New()
+			{
+				if (freeList == nullptr)
+				{
+					AddSlab(SLAB_OBJECTS);
+				}
+
+				Slot *slot = freeList;
+				freeList = slot->next;
+
+				T *object = new (slot->storage) T();
+				slot->alive = true;
+				count++;
+				return object;
+			}
+
+			/**
+			 * @brief Destroy an object and give its memory back to the pool.
+			 *
+			 * @param object The object, which has to come from Pool::New() of this pool.
+			 */
+			void Delete(T *object)
+			{
+				Slot *slot = reinterpret_cast<Slot *>(reinterpret_cast<std::byte *>(object) - offsetof(Slot, storage));
+				if (!slot->alive)
+				{
+					return;
+				}
+
+				object->~T();
+				slot->alive = false;
+				slot->next = freeList;
+				freeList = slot;
+				count--;
+			}
+
+			/**
+			 * @brief Make sure the pool can hold a number of extra objects without allocating.
+			 *
+			 * @param objects The number of objects the pool should be able to construct without
+			 * allocating.
+			 */
+			void Reserve(size_t objects)
+			{
+				if (capacity - count < objects)
+				{
+					AddSlab(objects - (capacity - count));
+				}
+			}
+
+			/**
+			 * @brief Get the number of objects alive in the pool.
+			 *
+			 * @return size_t The number of objects alive in the pool.
+			 */
+			size_t GetCount() const
+			{
+				return count;
+			}
+
+			/**
+			 * @brief Get the number of objects the pool has memory for.
+			 *
+			 * @return size_t The number of objects the pool has memory for.
+			 */
+			size_t GetCapacity() const
+			{
+				return capacity;
+			}
+
+			void Clear() override
+			{
+				freeList = nullptr;
+				for (auto &slab : slabs)
+				{
+					for (size_t i = 0; i < slab.second; i++)
+					{
+						Slot &slot = slab.first[i];
+						if (slot.alive)
+						{
+							reinterpret_cast<T *>(slot.storage)->~T();
+							slot.alive = false;
+						}
+						slot.next = freeList;
+						freeList = &slot;
+					}
+				}
+				count = 0;
+			}
+
+		private:
+			struct Slot
+			{
+				alignas(T) std::byte storage[sizeof(T)];
+				Slot *next = nullptr;
+				bool alive = false;
+			};
+
+			std::vector<std::pair<std::unique_ptr<Slot[]>, size_t>> slabs;
+			Slot *freeList = nullptr;
+			size_t count = 0;
+			size_t capacity = 0;
+
+			void AddSlab(size_t objects)
+			{
+				Slot *slab = new Slot[objects];
+
+				// Link the slots in order, so consecutive New() calls hand out adjacent memory.
+				for (size_t i = objects; i-- > 0;)
+				{
+					slab[i].next = freeList;
+					freeList = &slab[i];
+				}
+
+				slabs.push_back({std::unique_ptr<Slot[]>(slab), objects});
+				capacity += objects;
+			}
+		};
+
+		/**
+		 * @brief Get the pool for objects of type T, creating it the first time.
+		 *
+		 * @tparam T The type of the objects.
+		 * @return Pool<T>& The pool.
+		 */
+		template <typename T>
+		Pool<T> &GetPool()
+		{
+			static Pool<T> *pool = []()
+			{
+				Pool<T> *created = new Pool<T>();
+				pools.push_back(created);
+				return created;
+			}();
+			return *pool;
+		}
+
+		/**
+		 * @brief Pre-allocate memory for a number of objects of type T, so that creating that many
+		 * (for example with Entity::Instantiate() or Entity::AddComponent()) doesn't allocate.
+		 *
+		 * @tparam T The type of the objects, like Entity or a component type.
+		 * @param count The number of objects to reserve memory for.
+		 */
+		template <typename T>
+		void Reserve(size_t count)
+		{
+			GetPool<T>().Reserve(count);
+		}
+
+		/**
+		 * @brief An object waiting to go back to its pool.
+		 */
+		struct PendingRelease
+		{
+			void *object;
+			void (*release)(void *);
+		};
+
+		/**
+		 * @brief The objects destroyed this frame, released by Memory::FlushReleases().
+		 */
+		extern std::vector<PendingRelease> pendingReleases;
+
+		/**
+		 * @brief Give an object back to its pool at the end of the frame, so that pointers to it
+		 * stay valid until then.
+		 *
+		 * @tparam T The type of the object.
+		 * @param object The object, which has to come from Memory::GetPool<T>().
+		 */
+		template <typename T>
+		void Release(T *object)
+		{
+			pendingReleases.push_back({object, [](void *released)
+			{
+				GetPool<T>().Delete(static_cast<T *>(released));
+			}});
+		}
+
+		/**
+		 * @brief Give a component back to the pool of its type at the end of the frame.
+		 *
+		 * @param component The component, which has to come from Entity::AddComponent().
+		 */
+		void ReleaseComponent(BehaviourScript *component);
+
+		/**
+		 * @brief Give every object passed to Memory::Release() back to its pool.
+		 */
+		void FlushReleases();
+
+		/**
+		 * @brief An object owned by the engine, with the function that deletes it as its own type.
+		 */
+		struct HeapObject
+		{
+			void *object;
+			void (*destroy)(void *);
+		};
+
+		/**
+		 * @brief The objects deleted by Memory::Cleanup().
+		 */
+		extern std::vector<HeapObject> heapMemory;
+
+		/**
+		 * @brief Have Memory::Cleanup() delete an object.
+		 *
+		 * @tparam T The type the object is deleted as.
+		 * @param object The object, which has to be created with `new`.
+		 */
+		template <typename T>
+		void Own(T *object)
+		{
+			heapMemory.push_back({object, [](void *owned)
+			{
+				delete static_cast<T *>(owned);
+			}});
+		}
 
 		/**
 		 * @brief Cleans up all memory allocated by the engine.
@@ -0,0 +1,108 @@
+/*
+MIT License
+
+Copyright (c) 2022 Ducktape
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef DUCKTAPE_ENGINE_NAME_H_
+#define DUCKTAPE_ENGINE_NAME_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace DT
+{
+	/**
+	 * @brief A string interned in a global string table.
+	 *
+	 * Every distinct string is stored once, and a Name is just its index in the table, so names
+	 * are compared and hashed as integers. Strings are never removed from the table.
+	 */
+	class Name
+	{
+	public:
+		/**
+		 * @brief The empty name.
+		 */
+		Name() = default;
+
+		/**
+		 * @brief Intern a string, adding it to the string table if it's not there yet.
+		 *
+		 * @param text The string to intern.
+		 */
+		explicit Name(std::string_view text);
+
+		/**
+		 * @brief Look a string up in the string table, without adding it or allocating.
+		 *
+		 * @param text The string to look up.
+		 * @param name Set to the name of the string, if it was found.
+		 * @return true If the string has been interned before.
+		 * @return false If the string was never interned, so nothing can have it as a name.
+		 */
+		static bool TryGet(std::string_view text, Name &name);
+
+		/**
+		 * @brief Get the interned string.
+		 *
+		 * @return const std::string& The interned string, valid for the rest of the program.
+		 */
+		const std::string &ToString() const;
+
+		/**
+		 * @brief Get the index of the name in the string table.
+		 *
+		 * @return uint32_t The index of the name in the string table, 0 for the empty name.
+		 */
+		uint32_t GetId() const
+		{
+			return id;
+		}
+
+		bool operator==(const Name &other) const
+		{
+			return id == other.id;
+		}
+
+		bool operator!=(const Name &other) const
+		{
+			return id != other.id;
+		}
+
+	private:
+		uint32_t id = 0;
+	};
+}
+
+template <>
+struct std::hash<DT::Name>
+{
+	size_t operator()(const DT::Name &name) const noexcept
+	{
+		return std::hash<uint32_t>()(name.GetId());
+	}
+};
+
+#endif
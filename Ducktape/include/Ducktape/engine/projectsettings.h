@@ -25,6 +25,11 @@ SOFTWARE.
 #ifndef DUCKTAPE_ENGINE_PROJECTSETTINGS_H_
 #define DUCKTAPE_ENGINE_PROJECTSETTINGS_H_
 
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <string>
+
 #include <Ducktape/engine/color.h>
 #include <Ducktape/engine/vector2.h>
 #include <Ducktape/engine/scene.h>
@@ -51,6 +56,26 @@ namespace DT
 			 * @brief The initial size of the window.
 			 */
 			extern Vector2 initialResolution;
+
+			/**
+			 * @brief If the project should run without a window, for simulations on servers and
+			 * in batch jobs. Nothing is rendered, input is never pressed, frames are not limited,
+			 * and every frame advances Time::deltaTime by ProjectSettings::Physics::fixedDeltaTime.
+			 * Always true when Ducktape is built with DT_HEADLESS.
+			 */
+			extern bool headless;
+
+			/**
+			 * @brief The number of frames to run before the application closes by itself, 0 to run
+			 * until it is closed.
+			 */
+			extern unsigned long long maxFrames;
+
+			/**
+			 * @brief Checked after every frame, the application closes once it returns true.
+			 * Leave empty to only close with the window, Application::Close() or maxFrames.
+			 */
+			extern std::function<bool()> stopCondition;
 		}
 
 		/**
@@ -59,9 +84,92 @@ namespace DT
 		namespace Physics
 		{
 			/**
-			 * @brief The gravity all Rigidbodies will be affected by.
+			 * @brief The gravity all Rigidbodies will be affected by, as an acceleration in units per
+			 * second squared. Each Rigidbody scales it by its own gravity scale. The default of
+			 * (0, 60) matches the old (0, 1) velocity change per frame at 60 frames per second.
 			 */
 			extern Vector2 globalGravity;
+
+			/**
+			 * @brief If the physics world should be stepped with a fixed timestep instead of
+			 * the variable Time::deltaTime of each frame.
+			 */
+			extern bool fixedTimestep;
+
+			/**
+			 * @brief The time (in seconds) simulated by a single physics step, when fixedTimestep
+			 * is enabled. Must be greater than 0, other values are replaced by 1/60 with an error.
+			 */
+			extern float fixedDeltaTime;
+
+			/**
+			 * @brief The maximum number of fixed physics steps simulated in a single frame. Any time
+			 * beyond that is dropped, so that a slow frame doesn't cause an even slower one. Must be
+			 * greater than 0, other values are replaced by 1 with an error.
+			 */
+			extern int maxStepsPerFrame;
+
+			/**
+			 * @brief If the physics step should compute contacts and solve separate islands of bodies
+			 * in parallel on the JobSystem's worker threads. The simulation and the order of the
+			 * collision callbacks stay the same as on a single thread.
+			 */
+			extern bool parallelIslands;
+
+			/**
+			 * @brief If the physics world should give bit-identical results on every run, whatever
+			 * the number of worker threads, for lockstep multiplayer and reproducible benchmarks.
+			 *
+			 * The world is always stepped by fixedDeltaTime, even when fixedTimestep is disabled, and
+			 * in the default floating-point environment on every thread, whatever a library changed it
+			 * to. A checksum of the world is kept after every step in Physics::stepChecksum, to detect
+			 * desyncs. Results only match between builds made with DUCKTAPE_STRICT_FLOAT for the same
+			 * platform, with the same bodies created in the same order.
+			 */
+			extern bool deterministic;
+
+			/**
+			 * @brief The number of collision layers, one per bit of a Box2D category.
+			 */
+			constexpr int LAYER_COUNT = 16;
+
+			/**
+			 * @brief The names of the collision layers, looked up by Physics::GetLayer(). Colliders
+			 * are on layer 0, "Default", unless they're moved to another one.
+			 */
+			extern std::array<std::string, LAYER_COUNT> layerNames;
+
+			/**
+			 * @brief Which layers collide with each other, colliders on layers i and j only collide
+			 * when bit j of `layerCollisionMatrix[i]` is set. Everything collides by default.
+			 *
+			 * Edit it before the scene is loaded, or through Physics::SetLayerCollision() afterwards,
+			 * which keeps it symmetric and updates the colliders that already exist.
+			 */
+			extern std::array<uint16_t, LAYER_COUNT> layerCollisionMatrix;
+		}
+
+		/**
+		 * @brief Settings related to the JobSystem.
+		 */
+		namespace JobSystem
+		{
+			/**
+			 * @brief If components declared as `parallelSafe` should be ticked on the JobSystem's
+			 * worker threads.
+			 */
+			extern bool parallelTicks;
+
+			/**
+			 * @brief The number of worker threads to start, 0 to start one less than the number
+			 * of hardware threads.
+			 */
+			extern unsigned int workerCount;
+
+			/**
+			 * @brief The number of components ticked by a single job.
+			 */
+			extern size_t tickChunkSize;
 		}
 
 		/**
@@ -25,9 +25,13 @@ SOFTWARE.
 #ifndef DUCKTAPE_ENGINE_SCENE_H_
 #define DUCKTAPE_ENGINE_SCENE_H_
 
+#include <unordered_map>
 #include <vector>
 
 #include <Ducktape/engine/vector2.h>
+#include <Ducktape/engine/archetype.h>
+#include <Ducktape/engine/entityhandle.h>
+#include <Ducktape/engine/name.h>
 
 namespace DT
 {
@@ -70,10 +74,22 @@ namespace DT
 	{
 	public:
 		/**
-		 * @brief List of entities the scene contains.
+		 * @brief List of entities the scene contains. Destroying an entity moves the last entity
+		 * into its place, so the order of the list is not kept.
 		 */
 		std::vector<Entity *> entities;
 
+		/**
+		 * @brief Storage for the plain data entities of the scene.
+		 */
+		ArchetypeStorage archetypes;
+
+		/**
+		 * @brief Scenes are created by the user as derived classes and deleted by the engine
+		 * through a Scene pointer.
+		 */
+		virtual ~Scene() = default;
+
 		/**
 		 * @brief Called by the Scene Manager when the scene is loaded.
 		 */
@@ -83,6 +99,81 @@ namespace DT
 		 * @brief Called by the Scene Manager when another scene is loaded.
 		 */
 		void Destroy();
+
+		/**
+		 * @brief Add an entity to the scene and give it a handle.
+		 *
+		 * @param entity The entity to add.
+		 */
+		void AddEntity(Entity *entity);
+
+		/**
+		 * @brief Remove an entity from the scene in constant time, invalidating its handle.
+		 *
+		 * @param entity The entity to remove.
+		 */
+		void RemoveEntity(Entity *entity);
+
+		/**
+		 * @brief Get the entity a handle refers to.
+		 *
+		 * @param handle The handle of the entity.
+		 * @return Entity* The entity, or nullptr if it was destroyed.
+		 */
+		Entity *GetEntity(EntityHandle handle) const;
+
+		/**
+		 * @brief Check if a handle refers to an entity that is still in the scene.
+		 *
+		 * @param handle The handle to check.
+		 * @return true If the entity is still in the scene.
+		 * @return false If the entity was destroyed.
+		 */
+		bool IsValid(EntityHandle handle) const;
+
+		/**
+		 * @brief Find an entity in the scene by name, in constant time.
+		 *
+		 * @param name The name of the entity.
+		 * @return Entity* One of the entities with that name, nullptr if there is none.
+		 */
+		Entity *FindEntity(Name name) const;
+
+		/**
+		 * @brief Find every entity in the scene with a name.
+		 *
+		 * @param name The name of the entities.
+		 * @return const std::vector<Entity *>& The entities with that name, in no particular
+		 * order. Only valid until an entity is added, removed or renamed.
+		 */
+		const std::vector<Entity *> &FindEntities(Name name) const;
+
+		/**
+		 * @brief Update the name index when an entity in the scene is renamed.
+		 *
+		 * @param entity The entity, still carrying its old name.
+		 * @param newName The new name of the entity.
+		 * @return bool False if the entity isn't in the scene, it keeps its old name then.
+		 */
+		bool RenameEntity(Entity *entity, Name newName);
+
+	private:
+		struct EntitySlot
+		{
+			Entity *entity = nullptr;
+			uint32_t generation = 1;
+		};
+
+		// Shared by all scenes, so a handle from an unloaded scene can't match an entity of the
+		// scene that replaced it.
+		inline static std::vector<EntitySlot> entitySlots;
+		inline static std::vector<uint32_t> freeSlots;
+
+		std::unordered_map<Name, std::vector<Entity *>> nameIndex;
+
+		void FreeSlot(uint32_t index);
+		void IndexName(Entity *entity);
+		void UnindexName(Entity *entity);
 	};
 }
 
@@ -27,6 +27,9 @@ SOFTWARE.
 
 #include <Ducktape/engine/scene.h>
 #include <Ducktape/engine/memory.h>
+#include <Ducktape/engine/systems.h>
+#include <Ducktape/engine/commandbuffer.h>
+#include <Ducktape/engine/transformhierarchy.h>
 
 namespace DT
 {
@@ -48,12 +51,15 @@ namespace DT
 		void LoadScene()
 		{
 			T *scene = new T();
-			Memory::Cleanup();
-			Memory::heapMemory.push_back(scene);
 			if (currentScene != nullptr)
 			{
 				currentScene->Destroy();
 			}
+			CommandBuffer::Clear();
+			Systems::Clear();
+			TransformHierarchy::Clear();
+			Memory::Cleanup();
+			Memory::Own(scene);
 			currentScene = scene;
 			currentScene->Init();
 		}
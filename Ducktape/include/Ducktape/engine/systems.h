@@ -0,0 +1,186 @@
+/*
+MIT License
+
+Copyright (c) 2022 Ducktape
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef DUCKTAPE_ENGINE_SYSTEMS_H_
+#define DUCKTAPE_ENGINE_SYSTEMS_H_
+
+#include <vector>
+#include <type_traits>
+
+#include <Ducktape/engine/behaviourscript.h>
+#include <Ducktape/engine/commandbuffer.h>
+
+namespace DT
+{
+	/**
+	 * @brief A contiguous list of every component of one type that overrides `BehaviourScript::Tick()`.
+	 *
+	 * The list calls `Tick()` through a plain function pointer to that type's own `Tick()`, so updating
+	 * a list is a tight loop over an array instead of a virtual call per component per entity.
+	 */
+	class TickList
+	{
+	public:
+		/**
+		 * @brief The components in this list. Removed components leave a nullptr behind until the
+		 * list is compacted at the end of the frame, so that removing during a tick is safe.
+		 */
+		std::vector<BehaviourScript *> components;
+
+		/**
+		 * @brief Calls the `Tick()` of the list's component type without virtual dispatch.
+		 */
+		void (*tick)(BehaviourScript *) = nullptr;
+
+		/**
+		 * @brief If the component type of this list is `parallelSafe`.
+		 */
+		bool parallelSafe = false;
+
+		/**
+		 * @brief If a component was removed from the list since it was last compacted.
+		 */
+		bool needsCompaction = false;
+
+		/**
+		 * @brief Add a component to the list.
+		 *
+		 * @param component The component to add.
+		 */
+		void Add(BehaviourScript *component);
+
+		/**
+		 * @brief Remove a component from the list.
+		 *
+		 * @param component The component to remove.
+		 */
+		void Remove(BehaviourScript *component);
+
+		/**
+		 * @brief Tick every enabled component in the range [begin, end) of the list.
+		 */
+		void Tick(size_t begin, size_t end);
+
+		/**
+		 * @brief Drop the nullptr slots left behind by removed components.
+		 */
+		void Compact();
+	};
+
+	/**
+	 * @brief Namespace keeping the per-component-type update lists the engine ticks every frame.
+	 */
+	namespace Systems
+	{
+		/**
+		 * @brief Every tick list, in the order their component type was first added to an entity.
+		 */
+		extern std::vector<TickList *> tickLists;
+
+		/**
+		 * @brief If the component type T has its own `Tick()`, rather than the empty one of `BehaviourScript`.
+		 */
+		template <typename T>
+		constexpr bool overridesTick = !std::is_same_v<decltype(&T::Tick), void (BehaviourScript::*)()>;
+
+		/**
+		 * @brief If the component type T has its own `OnCollisionEnter()` or `OnCollisionExit()`.
+		 * Only components of such types are sent collision events.
+		 */
+		template <typename T>
+		constexpr bool overridesCollision = !std::is_same_v<decltype(&T::OnCollisionEnter), void (BehaviourScript::*)(Collision)> ||
+											!std::is_same_v<decltype(&T::OnCollisionExit), void (BehaviourScript::*)(Collision)>;
+
+		/**
+		 * @brief Get the tick list of the component type T, creating it on first use.
+		 *
+		 * @tparam T The component type.
+		 * @return TickList* The tick list of the component type.
+		 */
+		template <typename T>
+		TickList *GetTickList()
+		{
+			static TickList *list = nullptr;
+			if (list == nullptr)
+			{
+				list = new TickList();
+				list->tick = [](BehaviourScript *component) { static_cast<T *>(component)->T::Tick(); };
+				list->parallelSafe = T::parallelSafe;
+				tickLists.push_back(list);
+			}
+			return list;
+		}
+
+		/**
+		 * @brief Register a newly added component, types that don't override `Tick()` are skipped.
+		 * During the frame, the registration is recorded in the CommandBuffer, so the component
+		 * starts ticking on the next frame.
+		 *
+		 * @tparam T The type of the component.
+		 * @param component The component to register.
+		 */
+		template <typename T>
+		void Register(T *component)
+		{
+			if constexpr (overridesTick<T>)
+			{
+				TickList *list = GetTickList<T>();
+				if (CommandBuffer::IsRecording())
+				{
+					CommandBuffer::Record({CommandBuffer::CommandType::RegisterComponent, nullptr, component, list});
+				}
+				else
+				{
+					list->Add(component);
+				}
+			}
+		}
+
+		/**
+		 * @brief Remove a component from the tick list it's in, if any.
+		 *
+		 * @param component The component to unregister.
+		 */
+		void Unregister(BehaviourScript *component);
+
+		/**
+		 * @brief Tick every registered component. Lists of `parallelSafe` types are ticked on the
+		 * JobSystem first when ProjectSettings::JobSystem::parallelTicks is enabled, then the rest
+		 * on the main thread.
+		 */
+		void Tick();
+
+		/**
+		 * @brief Drop the slots of removed components from every tick list that has any.
+		 */
+		void Compact();
+
+		/**
+		 * @brief Empty every tick list, used when a scene is unloaded.
+		 */
+		void Clear();
+	}
+}
+
+#endif
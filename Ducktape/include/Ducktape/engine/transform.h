@@ -25,45 +25,123 @@ SOFTWARE.
 #ifndef DUCKTAPE_ENGINE_TRANSFORM_H_
 #define DUCKTAPE_ENGINE_TRANSFORM_H_
 
+#include <algorithm>
 #include <vector>
 
 #include <box2d/box2d.h>
 
 #include <Ducktape/engine/behaviourscript.h>
 #include <Ducktape/engine/vector2.h>
+#include <Ducktape/engine/matrix3.h>
+#include <Ducktape/engine/transformhierarchy.h>
+#include <Ducktape/engine/dt_time.h>
 #include <Ducktape/physics/rigidbody.h>
 
 namespace DT
 {
     /**
      * @brief Component for managing position, rotation, and scale of an entity. This component also allows parent-child system, allowing for a hierarchy of entities where each one depend on their parent.
+     *
+     * The local position, rotation and scale are what's stored. The world values and the local and
+     * world matrices are cached, and only recalculated when they're read after a change. Changing a
+     * transform only flags it and its children as dirty, so moving a parent with many children
+     * doesn't recalculate any of them until they are read. Once per frame, TransformHierarchy
+     * recalculates every transform still out of date in a single batch.
+     *
+     * Rotations are in radians, like the physics bodies and Matrix3::TRS(). They are converted to
+     * degrees only where they are handed to SFML.
      */
     class Transform : public BehaviourScript
     {
     private:
+        Vector2 localPosition = Vector2(0.0, 0.0);
+        float localRotation = 0.0f;
+        Vector2 localScale = Vector2(1.0, 1.0);
+
         Vector2 position = Vector2(0.0, 0.0);
-        float rotation;
+        float rotation = 0.0f;
         Vector2 scale = Vector2(1.0, 1.0);
 
-        Vector2 localPosition = Vector2(0.0, 0.0);
-        float localRotation;
-        Vector2 localScale = Vector2(1.0, 1.0);
+        Matrix3 localMatrix;
+        Matrix3 worldMatrix;
+        bool localDirty = false;
+        bool worldDirty = false;
+
+        Transform *parent = nullptr;
+        std::vector<Transform *> children;
+
+        size_t hierarchySlot = 0;
+
+        Vector2 previousPosition = Vector2(0.0, 0.0);
+        float previousRotation = 0.0f;
+        bool hasPreviousState = false;
 
         void OnTransformChange();
 
+        /**
+         * @brief Flag the local values as changed, and the world values of this transform and all
+         * of its children as out of date.
+         */
+        void MarkDirty();
+
+        /**
+         * @brief Flag the world values of this transform and all of its children as out of date.
+         */
+        void MarkWorldDirty();
+
+        /**
+         * @brief Recalculate the cached world values, if they are out of date.
+         */
+        void UpdateWorld();
+
+        friend class TransformHierarchy;
+
     public:
+        void Constructor();
+
+        void OnDestroy();
+
         /**
-         * @brief Parent of the current transform.
+         * @brief Get the parent of the transform.
+         *
+         * @return Transform* Parent of the transform, nullptr if it has none.
          */
-        Transform *parent = nullptr;
+        Transform *GetParent();
 
         /**
-         * @brief Children of the current transform.
+         * @brief Get the children of the transform.
+         *
+         * @return const std::vector<Transform *>& Children of the transform.
          */
-        std::vector<Transform *> children;
+        const std::vector<Transform *> &GetChildren();
+
+        /**
+         * @brief Set the parent of the transform.
+         *
+         * @param newParent New parent of the transform, nullptr to remove the parent.
+         * @param keepWorldValues If the world position, rotation, and scale should stay the same, rather
+         * than the local ones.
+         */
+        void SetParent(Transform *newParent, bool keepWorldValues = true);
+
+        /**
+         * @brief Get the matrix transforming from the local space of the transform to the space of
+         * its parent.
+         *
+         * @return const Matrix3& The local matrix of the transform.
+         */
+        const Matrix3 &GetLocalMatrix();
+
+        /**
+         * @brief Get the matrix transforming from the local space of the transform to world space.
+         *
+         * @return const Matrix3& The world matrix of the transform.
+         */
+        const Matrix3 &GetWorldMatrix();
 
         /**
-         * @brief Set the position of the transform.
+         * @brief Set the position of the transform. The transform is teleported there
+         * in one frame, rendering doesn't interpolate from the pose before the move.
          *
          * @param newPosition New position of the transform.
          */
@@ -74,19 +152,27 @@ namespace DT
          *
          * @return Vector2 Position of the transform.
          */
+        Vector2 GetPosition();
+
+        /**
+         * @brief Get the position of the transform, same as Transform::GetPosition().
+         *
+         * @return Vector2 Position of the transform.
+         */
         Vector2 SetPosition();
 
         /**
-         * @brief Set the rotation of the transform.
+         * @brief Set the rotation of the transform. The transform is teleported there
+         * in one frame, rendering doesn't interpolate from the pose before the move.
          *
-         * @param newRotation New rotation of the transform.
+         * @param newRotation New rotation of the transform, in radians.
          */
         void SetRotation(float newRotation);
 
         /**
          * @brief Get the rotation of the transform.
          *
-         * @return float Rotation of the transform.
+         * @return float Rotation of the transform, in radians.
          */
         float GetRotation();
 
@@ -105,7 +191,8 @@ namespace DT
         Vector2 GetScale();
 
         /**
-         * @brief Set the local position of the transform.
+         * @brief Set the local position of the transform. The transform is teleported there
+         * in one frame, rendering doesn't interpolate from the pose before the move.
          *
          * @param newLocalPosition New local position of the transform.
          */
@@ -119,16 +206,17 @@ namespace DT
         Vector2 GetLocalPosition();
 
         /**
-         * @brief Set the local rotation of the transform.
+         * @brief Set the local rotation of the transform. The transform is teleported there
+         * in one frame, rendering doesn't interpolate from the pose before the move.
          *
-         * @param newLocalRotation New local rotation of the transform.
+         * @param newLocalRotation New local rotation of the transform, in radians.
          */
         void SetLocalRotation(float newLocalRotation);
 
         /**
          * @brief Get the local rotation of the transform.
          *
-         * @return float Local rotation of the transform.
+         * @return float Local rotation of the transform, in radians.
          */
         float GetLocalRotation();
 
@@ -147,14 +235,38 @@ namespace DT
         Vector2 GetLocalScale();
 
         /**
-         * @brief Recalculate the local position, rotation, and scale.
+         * @brief Set the position and rotation of the transform from its physics body, without
+         * writing them back to the body the way Transform::SetPosition() and
+         * Transform::SetRotation() do.
+         *
+         * @param newPosition New position of the transform.
+         * @param newRotation New rotation of the transform.
+         */
+        void SetPoseFromPhysics(Vector2 newPosition, float newRotation);
+
+        /**
+         * @brief Store the pose the transform had before the latest fixed physics step.
+         *
+         * @param prevPosition Position before the step.
+         * @param prevRotation Rotation before the step.
          */
-        void RecalculateLocalValues();
+        void StorePreviousState(Vector2 prevPosition, float prevRotation);
 
         /**
-         * @brief Recalculate the world position, rotation, and scale.
+         * @brief Get the position to render the transform at, interpolated between the last two
+         * fixed physics steps using Time::interpolationAlpha.
+         *
+         * @return Vector2 Interpolated position of the transform.
+         */
+        Vector2 GetInterpolatedPosition();
+
+        /**
+         * @brief Get the rotation to render the transform at, interpolated between the last two
+         * fixed physics steps using Time::interpolationAlpha.
+         *
+         * @return float Interpolated rotation of the transform, in radians.
          */
-        void RecalculateWorldValues();
+        float GetInterpolatedRotation();
     };
 }
 
@@ -0,0 +1,114 @@
+/*
+MIT License
+
+Copyright (c) 2022 Ducktape
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef DUCKTAPE_ENGINE_TRANSFORMHIERARCHY_H_
+#define DUCKTAPE_ENGINE_TRANSFORMHIERARCHY_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace DT
+{
+    class Transform;
+
+    /**
+     * @brief Flattened copy of the Transform hierarchy, used to recalculate every out of date world
+     * matrix in a single batch each frame.
+     *
+     * The transforms are kept in an array sorted by depth, so every parent comes before its children
+     * and each depth is a contiguous range. Transforms of the same depth never depend on each other,
+     * so every depth is processed with SSE, four transforms at a time, and large depths are split
+     * over the JobSystem's worker threads. Transforms that are read before the batch runs still
+     * update themselves on their own.
+     */
+    class TransformHierarchy
+    {
+    public:
+        /**
+         * @brief The number of transforms of the same depth processed by a single job.
+         */
+        static constexpr size_t CHUNK_SIZE = 1024;
+
+        /**
+         * @brief Add a transform to the hierarchy.
+         *
+         * @param transform The transform to add.
+         */
+        static void Add(Transform *transform);
+
+        /**
+         * @brief Remove a transform from the hierarchy.
+         *
+         * @param transform The transform to remove.
+         */
+        static void Remove(Transform *transform);
+
+        /**
+         * @brief Flag the hierarchy as changed, so the flattened array is rebuilt by the next update.
+         */
+        static void MarkStructureDirty();
+
+        /**
+         * @brief Flag that some transform has out of date world values.
+         */
+        static void MarkTransformsDirty();
+
+        /**
+         * @brief Recalculate the world values of every out of date transform. Called by the engine
+         * once per frame, before the systems tick.
+         */
+        static void Update();
+
+        /**
+         * @brief Forget every transform, used when a scene is unloaded.
+         */
+        static void Clear();
+
+    private:
+        // Every transform, in no order.
+        static std::vector<Transform *> transforms;
+
+        // The transforms sorted by depth, and where each depth starts in it.
+        static std::vector<Transform *> order;
+        static std::vector<size_t> depthStarts;
+        static std::vector<int32_t> parents;
+        static std::vector<uint8_t> dirty;
+
+        // The local and world values of the sorted transforms, one array per value.
+        static std::vector<float> local[9];
+        static std::vector<float> world[9];
+
+        static bool structureDirty;
+        static std::atomic<bool> transformsDirty;
+
+        static void Rebuild();
+        static void Gather();
+        static void Propagate(size_t begin, size_t end);
+        static void Scatter();
+    };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,74 @@
+/*
+MIT License
+
+Copyright (c) 2022 Ducktape
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef DUCKTAPE_ENGINE_TYPEINDEX_H_
+#define DUCKTAPE_ENGINE_TYPEINDEX_H_
+
+#include <atomic>
+#include <cstddef>
+
+namespace DT
+{
+	/**
+	 * @brief Hands out small, dense indices to types at runtime, without RTTI.
+	 *
+	 * Every type gets its index the first time `TypeIndex<Family>::Get<T>()` is called for it, and
+	 * keeps it for the rest of the program. Indices are counted separately for every `Family`, so
+	 * unrelated uses (like data components and BehaviourScripts) don't spread each other's indices.
+	 *
+	 * @tparam Family The family the indices are counted in.
+	 */
+	template <typename Family>
+	class TypeIndex
+	{
+	public:
+		/**
+		 * @brief Get the index of the type T.
+		 *
+		 * @tparam T The type to get the index of.
+		 * @return size_t The index of the type, from 0 to TypeIndex::Count() - 1.
+		 */
+		template <typename T>
+		static size_t Get()
+		{
+			static const size_t index = count++;
+			return index;
+		}
+
+		/**
+		 * @brief Get the number of types that have been given an index so far.
+		 *
+		 * @return size_t The number of types that have been given an index.
+		 */
+		static size_t Count()
+		{
+			return count;
+		}
+
+	private:
+		inline static std::atomic<size_t> count = 0;
+	};
+}
+
+#endif
@@ -40,7 +40,12 @@ namespace DT
     {
     private:
         Rigidbody2D *rb;
-        b2Fixture *fixture;
+        b2Fixture *fixture = nullptr;
+
+        /**
+         * @brief The collision layer of the collider.
+         */
+        int layer = 0;
 
         /**
          * @brief The width and height of the box collider.
@@ -50,7 +55,7 @@ namespace DT
     public:
         void Constructor();
 
-        void Tick();
+        void OnDestroy();
 
         /**
          * @brief Get the scale of the collider.
@@ -100,6 +105,24 @@ namespace DT
          * @param val If the collider is a trigger or not.
          */
         void SetIsTrigger(bool val);
+
+        /**
+         * @brief Get the collision layer of the collider.
+         * @return int The index of the layer in ProjectSettings::Physics::layerNames.
+         */
+        int GetLayer();
+
+        /**
+         * @brief Move the collider to another collision layer.
+         * @param val The index of the layer.
+         */
+        void SetLayer(int val);
+
+        /**
+         * @brief Move the collider to another collision layer.
+         * @param layerName The name of the layer.
+         */
+        void SetLayer(std::string_view layerName);
     };
 }
 
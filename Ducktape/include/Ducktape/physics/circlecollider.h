@@ -38,7 +38,12 @@ namespace DT
     {
     private:
         Rigidbody2D *rb;
-        b2Fixture *fixture;
+        b2Fixture *fixture = nullptr;
+
+        /**
+         * @brief The collision layer of the collider.
+         */
+        int layer = 0;
 
         /**
          * @brief The radius of the circle collider.
@@ -48,7 +53,7 @@ namespace DT
     public:
         void Constructor();
 
-        void Tick();
+        void OnDestroy();
 
         /**
          * @brief Get the radius of the collider.
@@ -98,6 +103,24 @@ namespace DT
          * @param val If the collider is a trigger or not.
          */
         void SetIsTrigger(bool val);
+
+        /**
+         * @brief Get the collision layer of the collider.
+         * @return int The index of the layer in ProjectSettings::Physics::layerNames.
+         */
+        int GetLayer();
+
+        /**
+         * @brief Move the collider to another collision layer.
+         * @param val The index of the layer.
+         */
+        void SetLayer(int val);
+
+        /**
+         * @brief Move the collider to another collision layer.
+         * @param layerName The name of the layer.
+         */
+        void SetLayer(std::string_view layerName);
     };
 }
 
@@ -25,8 +25,6 @@ SOFTWARE.
 #ifndef DUCKTAPE_PHYSICS_COLLISION_H_
 #define DUCKTAPE_PHYSICS_COLLISION_H_
 
-#include <box2d/box2d.h>
-
 #include <Ducktape/engine/vector2.h>
 
 namespace DT
@@ -36,25 +34,42 @@ namespace DT
 	/**
 	 * @brief Class holding data related to a collision.
 	 */
-	class Collision : public b2RayCastCallback
+	class Collision
 	{
 	public:
 		/**
-		 * @brief The direction the collision is pointing towards.
+		 * @brief The direction the collision is pointing towards. For collision events, this points
+		 * from the receiving entity towards the other one.
 		 */
 		Vector2 normal;
 
 		/**
-		 * @brief The point of collision.
+		 * @brief The point of collision, the same as `points[0]` for collision events.
 		 */
 		Vector2 point;
 
 		/**
-		 * @brief The body that was collided with.
+		 * @brief The body that was collided with. For OnCollisionExit(), this is nullptr if that
+		 * entity has been destroyed.
 		 */
-		Entity *body;
+		Entity *body = nullptr;
 
-		float ReportFixture(b2Fixture *_fixture, const b2Vec2 &_point, const b2Vec2 &_normal, float _fraction);
+		/**
+		 * @brief The number of valid entries in `points` and `normalImpulses`. 0 for sensors, and
+		 * for OnCollisionExit().
+		 */
+		int pointCount = 0;
+
+		/**
+		 * @brief The contact points, in world space.
+		 */
+		Vector2 points[2];
+
+		/**
+		 * @brief The normal impulse applied at each contact point by the step the collision
+		 * started in.
+		 */
+		float normalImpulses[2] = {0.0f, 0.0f};
 	};
 }
 
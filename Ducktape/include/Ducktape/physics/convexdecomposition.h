@@ -0,0 +1,73 @@
+/*
+MIT License
+
+Copyright (c) 2022 Ducktape
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef DUCKTAPE_PHYSICS_CONVEXDECOMPOSITION_H_
+#define DUCKTAPE_PHYSICS_CONVEXDECOMPOSITION_H_
+
+#include <memory>
+#include <vector>
+
+#include <Ducktape/engine/vector2.h>
+
+namespace DT
+{
+	/**
+	 * @brief Splits simple polygons, concave or with any number of points, into convex pieces
+	 * that Box2D can collide.
+	 *
+	 * The polygon is triangulated by ear clipping, then the Hertel-Mehlhorn algorithm removes
+	 * every diagonal whose removal keeps both sides convex, leaving at most four times the
+	 * minimal number of pieces. Pieces are kept to `b2_maxPolygonVertices` points, and their
+	 * points are welded like Box2D welds them, so parts thinner than `b2_linearSlop`, like the tip
+	 * of a thin spike, are dropped instead of turning into degenerate shapes.
+	 */
+	namespace ConvexDecomposition
+	{
+		/**
+		 * @brief Convex pieces, each a list of points in counter-clockwise order.
+		 */
+		using Pieces = std::vector<std::vector<Vector2>>;
+
+		/**
+		 * @brief Decompose a polygon into convex pieces.
+		 *
+		 * Results are cached by the hash of the points, so decomposing the same outline again,
+		 * like when instantiating a prefab many times, only costs a lookup. Safe to call from
+		 * any thread.
+		 *
+		 * @param points The points of the polygon in either winding order, without
+		 * self-intersections.
+		 * @return std::shared_ptr<const Pieces> The convex pieces, empty if the polygon couldn't
+		 * be decomposed.
+		 */
+		std::shared_ptr<const Pieces> Decompose(const std::vector<Vector2> &points);
+
+		/**
+		 * @brief Forget every cached decomposition.
+		 */
+		void ClearCache();
+	}
+}
+
+#endif
\ No newline at end of file
@@ -40,13 +40,18 @@ namespace DT
     {
     private:
         Rigidbody2D *rb;
-        b2Fixture *fixture;
+        b2Fixture *fixture = nullptr;
+
+        /**
+         * @brief The collision layer of the collider.
+         */
+        int layer = 0;
         std::vector<Vector2> points;
 
     public:
         void Constructor();
 
-        void Tick();
+        void OnDestroy();
 
         /**
          * @brief Get the points of the collider.
@@ -74,7 +79,7 @@ namespace DT
         bool GetIsTrigger();
 
         /**
-         * @brief Set the points of the collider.
+         * @brief Set the points of the collider. The collider has no shape until its points are set.
          * @param points The points of the collider.
          */
         void SetPoints(std::vector<Vector2> points);
@@ -96,6 +101,24 @@ namespace DT
          * @param val If the collider is a trigger or not.
          */
         void SetIsTrigger(bool val);
+
+        /**
+         * @brief Get the collision layer of the collider.
+         * @return int The index of the layer in ProjectSettings::Physics::layerNames.
+         */
+        int GetLayer();
+
+        /**
+         * @brief Move the collider to another collision layer.
+         * @param val The index of the layer.
+         */
+        void SetLayer(int val);
+
+        /**
+         * @brief Move the collider to another collision layer.
+         * @param layerName The name of the layer.
+         */
+        void SetLayer(std::string_view layerName);
     };
 }
 
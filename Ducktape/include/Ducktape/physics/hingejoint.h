@@ -47,7 +47,6 @@ namespace DT
 	public:
 		void Constructor();
 
-		void Tick();
 		void OnDestroy();
 
 		/**
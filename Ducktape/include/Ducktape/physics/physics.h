@@ -25,15 +25,31 @@ SOFTWARE.
 #ifndef DUCKTAPE_PHYSICS_PHYSICS_H_
 #define DUCKTAPE_PHYSICS_PHYSICS_H_
 
+#include <cstdint>
+#include <initializer_list>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+
 #include <box2d/box2d.h>
 
 #include <Ducktape/engine/projectsettings.h>
+#include <Ducktape/engine/dt_time.h>
 #include <Ducktape/engine/entity.h>
+#include <Ducktape/engine/jobsystem.h>
+#include <Ducktape/physics/queries.h>
 
 namespace DT
 {
+	class Rigidbody2D;
+
 	/**
 	 * @brief Handling contact callbacks.
+	 *
+	 * Box2D reports contacts per pair of fixtures, in the middle of b2World::Step(). They are
+	 * counted per pair of entities instead, so a collision starts when the first fixtures of two
+	 * entities touch and ends when the last ones stop touching. The resulting events are queued,
+	 * and sent by ContactListener::Dispatch() once the step is over.
 	 */
 	class ContactListener : public b2ContactListener
 	{
@@ -41,6 +57,92 @@ namespace DT
 		void BeginContact(b2Contact *contact);
 
 		void EndContact(b2Contact *contact);
+
+		void PostSolve(b2Contact *contact, const b2ContactImpulse *impulse);
+
+		/**
+		 * @brief Send the queued events to the components of both entities that receive collisions.
+		 */
+		void Dispatch();
+
+		/**
+		 * @brief Drop the queued events and recount the touching contacts, after the contacts of
+		 * the world were replaced by Physics::RestoreState().
+		 *
+		 * @param contactList The first contact of the world.
+		 */
+		void Reset(b2Contact *contactList);
+
+	private:
+		struct Event
+		{
+			EntityHandle entityA;
+			EntityHandle entityB;
+			bool enter;
+
+			/**
+			 * @brief The contact that started the collision, used to pick up its impulses in PostSolve().
+			 */
+			b2Contact *contact;
+
+			Vector2 normal;
+			int pointCount;
+			Vector2 points[2];
+			float normalImpulses[2];
+		};
+
+		static uint64_t PairKey(EntityHandle a, EntityHandle b);
+
+		/**
+		 * @brief The number of touching fixture contacts of each pair of entities.
+		 */
+		std::unordered_map<uint64_t, int> touching;
+
+		/**
+		 * @brief The index in `events` of the latest enter event of each pair, until it's dispatched.
+		 */
+		std::unordered_map<uint64_t, size_t> pendingEnter;
+
+		std::vector<Event> events;
+		std::vector<Event> dispatching;
+	};
+
+	/**
+	 * @brief Lets Box2D split its work over the JobSystem's worker threads.
+	 */
+	class JobSystemTaskExecutor : public b2TaskExecutor
+	{
+	public:
+		int32 GetThreadCount() const;
+
+		void ParallelFor(b2Task *task, int32 count, int32 minRange);
+	};
+
+	/**
+	 * @brief Measures of the quality of the broadphase tree, see Physics::GetBroadphaseStats().
+	 */
+	struct BroadphaseStats
+	{
+		/**
+		 * @brief The number of proxies in the tree, one per child shape of every enabled collider.
+		 */
+		int proxyCount;
+
+		/**
+		 * @brief The height of the tree, the depth of its deepest proxy.
+		 */
+		int height;
+
+		/**
+		 * @brief The largest difference in height between the two children of a node.
+		 */
+		int maxBalance;
+
+		/**
+		 * @brief The summed perimeter of every node divided by the perimeter of the root. Lower is
+		 * better, queries and raycasts visit fewer nodes in a tree with a lower ratio.
+		 */
+		float areaRatio;
 	};
 
 	/**
@@ -48,13 +150,50 @@ namespace DT
 	 */
 	namespace Physics
 	{
-		extern b2Vec2 b2Gravity;
 		extern b2World physicsWorld;
 		extern int32 velocityIterations;
 		extern int32 positionIterations;
-		extern Vector2 globalGravity;
+
+		/**
+		 * @brief Time that has passed but hasn't been simulated yet by a fixed physics step.
+		 */
+		extern float accumulator;
 
 		extern ContactListener contactListener;
+		extern JobSystemTaskExecutor taskExecutor;
+
+		/**
+		 * @brief The number of steps the physics world has been advanced by.
+		 */
+		extern uint64_t stepCount;
+
+		/**
+		 * @brief The checksum of the physics world after the latest step, only kept when
+		 * ProjectSettings::Physics::deterministic is enabled. Compare it between peers along with
+		 * stepCount to detect desyncs.
+		 */
+		extern uint64_t stepChecksum;
+
+		/**
+		 * @brief Rigidbodies whose collider shapes changed since the last step, see Rigidbody2D::MarkShapesDirty().
+		 */
+		extern std::vector<Rigidbody2D *> dirtyRigidbodies;
+
+		/**
+		 * @brief The number of batches opened by Physics::BeginBatch() that haven't been ended yet.
+		 */
+		extern int batchDepth;
+
+		/**
+		 * @brief Rigidbodies created during the current batch, enabled when it ends.
+		 */
+		extern std::vector<Rigidbody2D *> batchedRigidbodies;
+
+		/**
+		 * @brief Every dynamic and kinematic rigidbody, the only ones whose Transforms physics moves.
+		 * Rigidbody2D::SetType() keeps it up to date.
+		 */
+		extern std::vector<Rigidbody2D *> movableRigidbodies;
 
 		/**
 		 * @brief Initialize the physics world.
@@ -62,12 +201,208 @@ namespace DT
 		void Init();
 
 		/**
-		 * @brief Send a raycast from a point origin to a direction.
+		 * @brief Change the gravity of the physics world at runtime. Sleeping bodies are woken so
+		 * they start falling the new way.
+		 *
+		 * @param gravity The new gravity, as an acceleration in units per second squared.
+		 */
+		void SetGravity(Vector2 gravity);
+
+		/**
+		 * @brief Get the gravity of the physics world, set from ProjectSettings::Physics::globalGravity
+		 * by Physics::Init() and changed by Physics::SetGravity().
+		 *
+		 * @return Vector2 The gravity, as an acceleration in units per second squared.
+		 */
+		Vector2 GetGravity();
+
+		/**
+		 * @brief Get the index of a collision layer from its name in ProjectSettings::Physics::layerNames.
+		 *
+		 * @param name The name of the layer.
+		 * @return int The index of the layer, -1 if there's no layer with that name.
+		 */
+		int GetLayer(std::string_view name);
+
+		/**
+		 * @brief Get the mask of some collision layers, for the layer masks of queries.
+		 *
+		 * Example:
+		 * ```cpp
+		 * uint16_t mask = Physics::GetLayerMask({"Walls", "Enemies"});
+		 * ```
+		 *
+		 * @param names The names of the layers.
+		 * @return uint16_t The mask with the bit of every layer set.
+		 */
+		uint16_t GetLayerMask(std::initializer_list<std::string_view> names);
+
+		/**
+		 * @brief Get the Box2D filter a collider on a layer is created with, its category is the
+		 * bit of the layer, and its mask the row of the layer in ProjectSettings::Physics::layerCollisionMatrix.
+		 *
+		 * @param layer The index of the layer.
+		 * @return b2Filter The filter of the layer.
+		 */
+		b2Filter GetLayerFilter(int layer);
+
+		/**
+		 * @brief Set if two collision layers collide with each other, and update the colliders that
+		 * already exist.
+		 *
+		 * @param layerA The index of the first layer.
+		 * @param layerB The index of the second layer.
+		 * @param collide If colliders on the layers should collide.
+		 */
+		void SetLayerCollision(int layerA, int layerB, bool collide);
+
+		/**
+		 * @brief Apply ProjectSettings::Physics::layerCollisionMatrix to every existing collider,
+		 * after it was edited directly.
+		 */
+		void RefreshLayerFilters();
+
+		/**
+		 * @brief Start a batch of collider setup, for spawning many physics entities at once.
+		 *
+		 * Rigidbodies created during a batch stay out of the broadphase until Physics::EndBatch(),
+		 * so their colliders can be added and shaped without touching it. Their final shapes are
+		 * then built into one subtree with the surface area heuristic, and the subtree is inserted
+		 * in the broadphase tree at once, instead of inserting each collider on its own. Batches can
+		 * be nested, only the outermost one counts. Bodies in a batch aren't found by queries until
+		 * it ends.
+		 *
+		 * Example:
+		 * ```cpp
+		 * Physics::BeginBatch();
+		 * for (int i = 0; i < 1000; i++)
+		 * {
+		 *     Entity *crate = Entity::Instantiate("Crate", Vector2(i, 0.0f), 0.0f, Vector2(1.0f, 1.0f));
+		 *     crate->AddComponent<BoxCollider2D>()->SetScale(Vector2(0.5f, 0.5f));
+		 * }
+		 * Physics::EndBatch();
+		 * ```
+		 */
+		void BeginBatch();
+
+		/**
+		 * @brief End a batch started with Physics::BeginBatch().
+		 */
+		void EndBatch();
+
+		/**
+		 * @brief If a batch of collider setup is open.
+		 *
+		 * @return bool If Physics::BeginBatch() was called more often than Physics::EndBatch().
+		 */
+		bool IsBatching();
+
+		/**
+		 * @brief Rebuild the broadphase tree top-down with the surface area heuristic.
+		 *
+		 * Colliders created outside of a batch are inserted in the tree one by one, which builds a
+		 * poorly balanced tree when a level loads thousands of them. Rebuilding it with all of them
+		 * in view makes queries, raycasts and finding new contacts faster. Loading a level in a
+		 * batch, see Physics::BeginBatch(), builds a tree as good without a rebuild.
+		 */
+		void RebuildBroadphase();
+
+		/**
+		 * @brief Measure the quality of the broadphase tree. This walks the whole tree, so it's meant
+		 * for profiling rather than for every frame.
+		 *
+		 * @return BroadphaseStats The stats of the tree.
+		 */
+		BroadphaseStats GetBroadphaseStats();
+
+		/**
+		 * @brief Refresh the broadphase proxies and mass of every rigidbody in dirtyRigidbodies,
+		 * called before stepping so a rigidbody is refreshed once per frame however many times its
+		 * colliders were edited.
+		 */
+		void SynchronizeShapes();
+
+		/**
+		 * @brief Advance the physics world by the time passed this frame.
+		 *
+		 * If ProjectSettings::Physics::fixedTimestep is enabled, the time is accumulated and
+		 * simulated in steps of ProjectSettings::Physics::fixedDeltaTime, at most
+		 * ProjectSettings::Physics::maxStepsPerFrame of them per frame, which is also the case when
+		 * ProjectSettings::Physics::deterministic is enabled. The remainder is
+		 * written to Time::interpolationAlpha so rendering can interpolate between steps.
+		 * Shapes edited since the last frame are synchronized first, and collision events of the
+		 * steps are dispatched once the Transforms have been synced.
+		 *
+		 * @param deltaTime The time passed since the last frame.
+		 */
+		void Step(float deltaTime);
+
+		/**
+		 * @brief Store the current pose of every awake body in its Transform's previous state,
+		 * used for interpolating between fixed steps, and remember the body for
+		 * Physics::SyncTransforms(). Static bodies aren't visited.
+		 */
+		void StorePreviousState();
+
+		/**
+		 * @brief Copy the pose of every body that was awake during the frame into its Transform,
+		 * called once after the bodies have been stepped. That includes bodies put to sleep or woken
+		 * by the steps, bodies asleep for the whole frame and static bodies haven't moved, so
+		 * they're skipped. Parents are synced before their children, whose local pose is worked out
+		 * from the world pose of their parent.
+		 */
+		void SyncTransforms();
+
+		/**
+		 * @brief Compute a checksum of the pose and velocity of every body, in the order of the
+		 * world's body list, which is newest first. Two worlds that stepped the same way have the
+		 * same checksum, any difference in their bits changes it.
+		 *
+		 * @return uint64_t The checksum of the physics world.
+		 */
+		uint64_t ComputeChecksum();
+
+		/**
+		 * @brief Save the state of the physics world, to rewind it later with Physics::RestoreState().
+		 *
+		 * The state holds the motion of every body, the parameters of their colliders, the joints,
+		 * the contacts with their warm starting impulses and the broadphase, so stepping again from
+		 * a restored state gives bit-identical results. It's cheap enough to save every fixed step
+		 * for rollback netcode or replay scrubbing, reusing the same states saves without allocating.
+		 *
+		 * Example:
+		 * ```cpp
+		 * b2WorldState states[8];
+		 * Physics::SaveState(states[frame % 8]);
+		 * ...
+		 * Physics::RestoreState(states[confirmedFrame % 8]);
+		 * ```
+		 *
+		 * @param state The state to overwrite.
+		 */
+		void SaveState(b2WorldState &state);
+
+		/**
+		 * @brief Rewind the physics world to a state saved by Physics::SaveState().
+		 *
+		 * The world must have the same rigidbodies, colliders and joints it had when the state was
+		 * saved. Collision events aren't sent for the contacts that change, and every Transform is
+		 * moved to its restored body without interpolation.
+		 *
+		 * @param state The state to restore.
+		 * @return bool If the state was restored, false if the world changed since it was saved.
+		 */
+		bool RestoreState(const b2WorldState &state);
+
+		/**
+		 * @brief Send a raycast from a point origin to a direction. Use Physics::RaycastBatch() to
+		 * cast many rays at once.
 		 *
 		 * @param origin The origin of the raycast.
-		 * @param direction The direction of the raycast.
+		 * @param direction The direction of the raycast, its length is the length of the ray.
 		 *
-		 * @return Collision Info about the collision that was hit by the raycast.
+		 * @return Collision Info about the closest collision hit by the raycast, its body is nullptr
+		 * if nothing was hit.
 		 */
 		Collision Raycast(Vector2 origin, Vector2 direction);
 	};
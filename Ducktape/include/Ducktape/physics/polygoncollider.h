@@ -30,23 +30,43 @@ SOFTWARE.
 #include <Ducktape/engine/behaviourscript.h>
 #include <Ducktape/physics/rigidbody.h>
 #include <Ducktape/engine/entity.h>
+#include <Ducktape/physics/convexdecomposition.h>
 
 namespace DT
 {
     /**
      * @brief Collider for 2D physics representing an arbitrary polygon defined by its vertices.
+     *
+     * The polygon may be concave and have any number of points, as long as its edges don't cross.
+     * It is decomposed into convex pieces by ConvexDecomposition, each attached to the rigidbody as
+     * its own fixture.
      */
     class PolygonCollider2D : public BehaviourScript
     {
     private:
         Rigidbody2D *rb;
-        b2Fixture *fixture;
+
+        /**
+         * @brief One fixture per convex piece of the polygon.
+         */
+        std::vector<b2Fixture *> fixtures;
+
+        /**
+         * @brief The collision layer of the collider.
+         */
+        int layer = 0;
         std::vector<Vector2> points;
 
+        float density = 0.0f;
+        float friction = 0.2f;
+        bool isTrigger = false;
+
+        void DestroyFixtures();
+
     public:
         void Constructor();
 
-        void Tick();
+        void OnDestroy();
 
         /**
          * @brief Get the points of the collider.
@@ -74,7 +94,7 @@ namespace DT
         bool GetIsTrigger();
 
         /**
-         * @brief Set the points of the collider.
+         * @brief Set the points of the collider. The collider has no shape until its points are set.
          * @param points The points of the collider.
          */
         void SetPoints(std::vector<Vector2> points);
@@ -96,6 +116,24 @@ namespace DT
          * @param val If the collider is a trigger or not.
          */
         void SetIsTrigger(bool val);
+
+        /**
+         * @brief Get the collision layer of the collider.
+         * @return int The index of the layer in ProjectSettings::Physics::layerNames.
+         */
+        int GetLayer();
+
+        /**
+         * @brief Move the collider to another collision layer.
+         * @param val The index of the layer.
+         */
+        void SetLayer(int val);
+
+        /**
+         * @brief Move the collider to another collision layer.
+         * @param layerName The name of the layer.
+         */
+        void SetLayer(std::string_view layerName);
     };
 }
 
@@ -0,0 +1,241 @@
+/*
+MIT License
+
+Copyright (c) 2022 Ducktape
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef DUCKTAPE_PHYSICS_QUERIES_H_
+#define DUCKTAPE_PHYSICS_QUERIES_H_
+
+#include <cstdint>
+#include <span>
+
+#include <box2d/box2d.h>
+
+#include <Ducktape/engine/vector2.h>
+#include <Ducktape/engine/entityhandle.h>
+
+namespace DT
+{
+	/**
+	 * @brief Which hits a ray or shape cast reports.
+	 */
+	enum class QueryMode
+	{
+		/**
+		 * @brief Only the hit closest to the origin.
+		 */
+		Closest,
+
+		/**
+		 * @brief The first hit found, which isn't necessarily the closest one. The cheapest mode,
+		 * meant for line of sight checks.
+		 */
+		Any,
+
+		/**
+		 * @brief Every hit, sorted from the closest to the furthest, as many as fit in the hit
+		 * slots of the cast.
+		 */
+		All
+	};
+
+	/**
+	 * @brief A ray to cast against the physics world.
+	 */
+	struct Ray
+	{
+		Vector2 origin;
+
+		/**
+		 * @brief The direction of the ray, its length is the length of the ray.
+		 */
+		Vector2 direction;
+	};
+
+	/**
+	 * @brief A shape to sweep through the physics world.
+	 */
+	struct ShapeCast
+	{
+		/**
+		 * @brief The shape to sweep, in its own local space. It has to outlive the cast.
+		 */
+		const b2Shape *shape = nullptr;
+
+		/**
+		 * @brief The position of the shape at the start of the cast.
+		 */
+		Vector2 origin;
+
+		/**
+		 * @brief The rotation of the shape during the cast, in radians.
+		 */
+		float angle = 0.0f;
+
+		/**
+		 * @brief The direction to sweep the shape in, its length is the length of the cast.
+		 */
+		Vector2 direction;
+	};
+
+	/**
+	 * @brief A collider hit by a ray or shape cast.
+	 */
+	struct RaycastHit
+	{
+		/**
+		 * @brief The entity of the collider that was hit.
+		 */
+		EntityHandle entity;
+
+		/**
+		 * @brief The point of the hit, in world space.
+		 */
+		Vector2 point;
+
+		/**
+		 * @brief The normal of the surface that was hit, pointing back towards the cast.
+		 */
+		Vector2 normal;
+
+		/**
+		 * @brief How far along the cast the hit is, as a fraction of its direction.
+		 */
+		float fraction = 0.0f;
+	};
+
+	namespace Physics
+	{
+		/**
+		 * @brief A layer mask that includes every layer.
+		 */
+		constexpr uint16_t ALL_LAYERS = 0xFFFF;
+
+		/**
+		 * @brief Cast a batch of rays, spread over the JobSystem's worker threads.
+		 *
+		 * Every ray gets an equal share of `hits`, so ray i writes its hits to the slots starting at
+		 * `i * (hits.size() / rays.size())`, and the number it wrote to `hitCounts[i]`. The Closest and
+		 * Any modes need a single slot per ray. Nothing is allocated, so the buffers can be reused
+		 * every frame. Sensors are never hit.
+		 *
+		 * Example:
+		 * ```cpp
+		 * std::vector<Ray> rays = ...;
+		 * std::vector<RaycastHit> hits(rays.size());
+		 * std::vector<uint32_t> hitCounts(rays.size());
+		 *
+		 * Physics::RaycastBatch(rays, hits, hitCounts, QueryMode::Any, wallLayer);
+		 * bool canSee = hitCounts[0] == 0;
+		 * ```
+		 *
+		 * @param rays The rays to cast.
+		 * @param hits The hit slots shared by the rays, at least one per ray.
+		 * @param hitCounts Receives the number of hits of every ray, one per ray.
+		 * @param mode Which hits to report.
+		 * @param layerMask Only colliders whose category bits are in the mask are hit.
+		 */
+		void RaycastBatch(std::span<const Ray> rays, std::span<RaycastHit> hits, std::span<uint32_t> hitCounts,
+						  QueryMode mode = QueryMode::Closest, uint16_t layerMask = ALL_LAYERS);
+
+		/**
+		 * @brief Sweep a batch of shapes, spread over the JobSystem's worker threads. The hits are
+		 * laid out the same way as for Physics::RaycastBatch().
+		 *
+		 * @param casts The shapes to sweep.
+		 * @param hits The hit slots shared by the casts, at least one per cast.
+		 * @param hitCounts Receives the number of hits of every cast, one per cast.
+		 * @param mode Which hits to report.
+		 * @param layerMask Only colliders whose category bits are in the mask are hit.
+		 */
+		void ShapeCastBatch(std::span<const ShapeCast> casts, std::span<RaycastHit> hits, std::span<uint32_t> hitCounts,
+							QueryMode mode = QueryMode::Closest, uint16_t layerMask = ALL_LAYERS);
+
+		/**
+		 * @brief Find the entities with a collider overlapping a box. The colliders are tested
+		 * exactly, not just their bounds. Every entity is reported once, however many of its
+		 * colliders overlap, and sensors are never reported. Nothing is allocated, so `results`
+		 * can be reused every frame.
+		 *
+		 * Example:
+		 * ```cpp
+		 * std::array<EntityHandle, 64> inRange;
+		 * size_t count = Physics::OverlapCircle(explosion, 5.0f, inRange, enemyLayer);
+		 *
+		 * for (size_t i = 0; i < count; i++)
+		 * {
+		 *     Entity::Get(inRange[i])->GetComponent<Health>()->Damage(10.0f);
+		 * }
+		 * ```
+		 *
+		 * @param center The center of the box.
+		 * @param size The width and height of the box.
+		 * @param angle The rotation of the box, in radians.
+		 * @param results Receives the overlapping entities, the query stops once it's full.
+		 * @param layerMask Only colliders whose category bits are in the mask are reported.
+		 *
+		 * @return size_t The number of entities written to `results`.
+		 */
+		size_t OverlapBox(Vector2 center, Vector2 size, float angle, std::span<EntityHandle> results, uint16_t layerMask = ALL_LAYERS);
+
+		/**
+		 * @brief Find the entities with a collider overlapping a circle, the same way as Physics::OverlapBox().
+		 *
+		 * @param center The center of the circle.
+		 * @param radius The radius of the circle.
+		 * @param results Receives the overlapping entities, the query stops once it's full.
+		 * @param layerMask Only colliders whose category bits are in the mask are reported.
+		 *
+		 * @return size_t The number of entities written to `results`.
+		 */
+		size_t OverlapCircle(Vector2 center, float radius, std::span<EntityHandle> results, uint16_t layerMask = ALL_LAYERS);
+
+		/**
+		 * @brief Find the entities with a collider overlapping a convex polygon, the same way as
+		 * Physics::OverlapBox().
+		 *
+		 * @param points The points of the polygon in world space, between 3 and 8 of them.
+		 * @param results Receives the overlapping entities, the query stops once it's full.
+		 * @param layerMask Only colliders whose category bits are in the mask are reported.
+		 *
+		 * @return size_t The number of entities written to `results`.
+		 */
+		size_t OverlapPolygon(std::span<const Vector2> points, std::span<EntityHandle> results, uint16_t layerMask = ALL_LAYERS);
+
+		/**
+		 * @brief Count the entities Physics::OverlapBox() would find, without a limit.
+		 */
+		size_t CountOverlapBox(Vector2 center, Vector2 size, float angle, uint16_t layerMask = ALL_LAYERS);
+
+		/**
+		 * @brief Count the entities Physics::OverlapCircle() would find, without a limit.
+		 */
+		size_t CountOverlapCircle(Vector2 center, float radius, uint16_t layerMask = ALL_LAYERS);
+
+		/**
+		 * @brief Count the entities Physics::OverlapPolygon() would find, without a limit.
+		 */
+		size_t CountOverlapPolygon(std::span<const Vector2> points, uint16_t layerMask = ALL_LAYERS);
+	}
+}
+
+#endif
\ No newline at end of file
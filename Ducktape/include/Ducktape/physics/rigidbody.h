@@ -25,6 +25,8 @@ SOFTWARE.
 #ifndef DUCKTAPE_PHYSICS_RIGIDBODY2D_H_
 #define DUCKTAPE_PHYSICS_RIGIDBODY2D_H_
 
+#include <algorithm>
+
 #include <box2d/box2d.h>
 
 #include <Ducktape/engine/behaviourscript.h>
@@ -102,18 +104,30 @@ namespace DT
      */
     class Rigidbody2D : public BehaviourScript
     {
-    private:
+    public:
+        b2Body *body;
+
         /**
-         * @brief The gravity scale of the rigidbody. The gravity affected by the Rigidbody will be ProjectSettings::globalGravity * Rigidbody2D::gravityScale.
+         * @brief The colliders and joints attached to this rigidbody, destroyed along with it.
          */
-        float gravityScale = 1.0f;
+        std::vector<BehaviourScript *> attachments;
 
-    public:
-        b2Body *body;
+        /**
+         * @brief If this rigidbody is waiting in Physics::dirtyRigidbodies.
+         */
+        bool shapesDirty = false;
 
-        void Constructor();
+        /**
+         * @brief The index of this rigidbody in Physics::movableRigidbodies, SIZE_MAX while it's static.
+         */
+        size_t movableIndex = SIZE_MAX;
 
-        void Tick();
+        /**
+         * @brief If the Transform of this rigidbody is waiting to be synced by Physics::SyncTransforms().
+         */
+        bool syncPending = false;
+
+        void Constructor();
 
         /**
          * @brief Get the velocity of the rigidbody.
@@ -339,6 +353,21 @@ namespace DT
         void ApplyAngularImpulse(float impulse);
 
         void OnDestroy();
+
+        /**
+         * @brief Remove a collider or joint from Rigidbody2D::attachments, when it is destroyed
+         * on its own.
+         *
+         * @param attachment The collider or joint to remove.
+         */
+        void Detach(BehaviourScript *attachment);
+
+        /**
+         * @brief Let the physics world know that the shape or density of a collider attached to this
+         * rigidbody was edited in place. The broadphase and the mass of the body are refreshed once,
+         * before the next physics step.
+         */
+        void MarkShapesDirty();
     };
 }
 
@@ -28,6 +28,7 @@ SOFTWARE.
 #include <Ducktape/engine/application.h>
 #include <Ducktape/engine/behaviourscript.h>
 #include <Ducktape/engine/entity.h>
+#include <Ducktape/engine/mathf.h>
 #include <Ducktape/engine/transform.h>
 #include <Ducktape/engine/vector2.h>
 
@@ -44,7 +45,10 @@ namespace DT
 		Color backgroundColor = Color(0, 0, 0, 255);
 
 		void Constructor();
+#ifndef DT_HEADLESS
+		// Headless builds leave Tick() out, so cameras are never visited by the tick loop.
 		void Tick();
+#endif
 
 		/**
 		 * @brief Convert pixel coordinates to metre coordinates.
@@ -33,6 +33,7 @@ SOFTWARE.
 #include <Ducktape/engine/color.h>
 #include <Ducktape/engine/debug.h>
 #include <Ducktape/engine/application.h>
+#include <Ducktape/engine/mathf.h>
 
 namespace DT
 {
@@ -41,6 +42,7 @@ namespace DT
      */
     namespace Renderer
     {
+#ifndef DT_HEADLESS
         /**
          * @brief Storing sprites that have been used before, so that they can be reused and
          * save a lot of memory.
@@ -55,13 +57,14 @@ namespace DT
          * @return int The index of the texture in the cache.
          */
         int LoadTextureFromCache(std::string path);
+#endif
 
         /**
-         * @brief Draw a sprite to the screen.
+         * @brief Draw a sprite to the screen, does nothing in headless builds.
          *
          * @param path The path to the images.
          * @param pos The position of the images (in pixel units).
-         * @param rot The rotation of the images.
+         * @param rot The rotation of the images, in radians.
          * @param scl The scale of the images.
          * @param pixelPerUnit The pixels per unit to use to draw the sprite.
          * @param color The color of the images.
@@ -84,7 +84,10 @@ namespace DT
         float GetPixelPerUnit();
         Color GetColor();
 
+#ifndef DT_HEADLESS
+        // Headless builds leave Tick() out, so sprites are never visited by the tick loop.
         void Tick();
+#endif
     };
 }
 
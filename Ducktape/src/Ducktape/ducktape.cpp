@@ -37,7 +37,7 @@ namespace DT
             return;
         }
         
-        Memory::heapMemory.push_back(SceneManager::currentScene);
+        Memory::Own(SceneManager::currentScene);
         SceneManager::currentScene->Init();
 
         for (size_t i = 0; i < SceneManager::currentScene->entities.size(); i++)
@@ -57,33 +57,49 @@ namespace DT
         Physics::Init();
         Application::Initialize();
 
-        // run the program as long as the window is open
+        if (ProjectSettings::JobSystem::parallelTicks || ProjectSettings::Physics::parallelIslands)
+        {
+            JobSystem::Init(ProjectSettings::JobSystem::workerCount);
+        }
+
+        // run the program as long as the window is open, or until a headless run is stopped
+        unsigned long long frames = 0;
         while (Application::IsOpen())
         {
             Input::Tick();
             Time::Update();
 
-            Application::renderWindow.clear((sf::Color)Camera::activeCamera->backgroundColor);
+            CommandBuffer::Begin();
 
-            for (size_t i = 0; i < SceneManager::currentScene->entities.size(); i++)
+#ifndef DT_HEADLESS
+            sf::RenderWindow *window = Application::renderWindow.get();
+            if (window != nullptr)
             {
-                if (SceneManager::currentScene->entities[i]->isDestroyed == false && SceneManager::currentScene->entities[i]->isEnabled && SceneManager::currentScene->entities[i] != nullptr)
-                {
-                    for (size_t j = 0; j < SceneManager::currentScene->entities[i]->components.size(); j++)
-                    {
-                        if (SceneManager::currentScene->entities[i]->components[j]->isDestroyed == false && SceneManager::currentScene->entities[i]->components[j]->isEnabled && SceneManager::currentScene->entities[i]->components[j] != nullptr)
-                        {
-                            SceneManager::currentScene->entities[i]->components[j]->Tick();
-                        }
-                    }
-                }
+                window->clear(Camera::activeCamera != nullptr ? (sf::Color)Camera::activeCamera->backgroundColor : sf::Color::Black);
             }
+#endif
 
-            Physics::physicsWorld.Step(Time::deltaTime, Physics::velocityIterations, Physics::positionIterations);
+            TransformHierarchy::Update();
+            Systems::Tick();
 
-            Application::renderWindow.setView(Application::view);
+            Physics::Step(Time::deltaTime);
 
-            Application::renderWindow.display();
+#ifndef DT_HEADLESS
+            if (window != nullptr)
+            {
+                window->setView(Application::view);
+                window->display();
+            }
+#endif
+
+            CommandBuffer::Flush();
+            Memory::FlushReleases();
+
+            frames++;
+            if ((ProjectSettings::Application::maxFrames != 0 && frames >= ProjectSettings::Application::maxFrames) || (ProjectSettings::Application::stopCondition && ProjectSettings::Application::stopCondition()))
+            {
+                Application::Close();
+            }
         }
 
         for (size_t i = 0; i < SceneManager::currentScene->entities.size(); i++)
@@ -99,5 +115,8 @@ namespace DT
                 }
             }
         }
+
+        JobSystem::Shutdown();
+        Application::Shutdown();
     }
 }
\ No newline at end of file
@@ -26,14 +26,26 @@ SOFTWARE.
 using namespace DT;
 
 Vector2 Application::Private::resolution = Vector2(500, 500);
+#ifndef DT_HEADLESS
 sf::View Application::view = sf::View(sf::Rect<float>(0.f, 0.f, Private::resolution.x, Private::resolution.y));
-sf::RenderWindow Application::renderWindow(sf::VideoMode(Private::resolution.x, Private::resolution.y), "Hello Ducktape", sf::Style::Default);
+std::unique_ptr<sf::RenderWindow> Application::renderWindow;
+#endif
+
+namespace
+{
+    bool running = false;
+}
 
 void Application::SetResolution(Vector2 resolution)
 {
     Private::resolution = resolution;
-    renderWindow.setSize(sf::Vector2u(Private::resolution.x, Private::resolution.y));
+#ifndef DT_HEADLESS
+    if (renderWindow != nullptr)
+    {
+        renderWindow->setSize(sf::Vector2u(Private::resolution.x, Private::resolution.y));
+    }
     view.setSize(Private::resolution.x, Private::resolution.y);
+#endif
 }
 
 Vector2 Application::GetResolution()
@@ -43,20 +55,59 @@ Vector2 Application::GetResolution()
 
 void Application::Initialize()
 {
-    renderWindow.setVerticalSyncEnabled(false);
-    renderWindow.setFramerateLimit(60);
-    renderWindow.setView(view);
-    renderWindow.setKeyRepeatEnabled(false);
-    renderWindow.setTitle(ProjectSettings::Application::windowTitle);
+    running = true;
+
+    if (IsHeadless())
+    {
+        SetResolution(ProjectSettings::Application::initialResolution);
+        return;
+    }
+
+#ifndef DT_HEADLESS
+    renderWindow = std::make_unique<sf::RenderWindow>(sf::VideoMode(Private::resolution.x, Private::resolution.y), ProjectSettings::Application::windowTitle, sf::Style::Default);
+    renderWindow->setVerticalSyncEnabled(false);
+    renderWindow->setFramerateLimit(60);
+    renderWindow->setView(view);
+    renderWindow->setKeyRepeatEnabled(false);
     SetResolution(ProjectSettings::Application::initialResolution);
+#endif
+}
+
+bool Application::IsHeadless()
+{
+#ifdef DT_HEADLESS
+    return true;
+#else
+    return ProjectSettings::Application::headless;
+#endif
 }
 
 bool Application::IsOpen()
 {
-    return renderWindow.isOpen();
+#ifndef DT_HEADLESS
+    if (renderWindow != nullptr)
+    {
+        return renderWindow->isOpen();
+    }
+#endif
+    return running;
 }
 
 void Application::Close()
 {
-    renderWindow.close();
+    running = false;
+#ifndef DT_HEADLESS
+    if (renderWindow != nullptr)
+    {
+        renderWindow->close();
+    }
+#endif
+}
+
+void Application::Shutdown()
+{
+    running = false;
+#ifndef DT_HEADLESS
+    renderWindow.reset();
+#endif
 }
\ No newline at end of file
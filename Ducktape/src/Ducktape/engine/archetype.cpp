@@ -0,0 +1,278 @@
+/*
+MIT License
+
+Copyright (c) 2022 Ducktape
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <Ducktape/engine/archetype.h>
+#include <Ducktape/engine/debug.h>
+using namespace DT;
+
+namespace
+{
+	size_t AlignUp(size_t value, size_t alignment)
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+}
+
+Archetype::Archetype(ComponentSignature signature, const std::vector<size_t> &typeSizes, const std::vector<size_t> &typeAlignments)
+	: signature(signature), offsets(MAX_DATA_COMPONENTS, 0)
+{
+	size_t bytesPerEntity = sizeof(DataEntity);
+	for (size_t type = 0; type < MAX_DATA_COMPONENTS; type++)
+	{
+		if (!signature.test(type))
+		{
+			continue;
+		}
+
+		types.push_back(type);
+		bytesPerEntity += typeSizes[type];
+	}
+
+	// Every array in the chunk is aligned for its type, so the padding may leave room for a
+	// little less than CHUNK_SIZE / bytesPerEntity entities.
+	capacity = std::max<size_t>(CHUNK_SIZE / bytesPerEntity, 1);
+	while (true)
+	{
+		size_t offset = capacity * sizeof(DataEntity);
+		for (size_t type : types)
+		{
+			offset = AlignUp(offset, typeAlignments[type]);
+			offsets[type] = offset;
+			offset += capacity * typeSizes[type];
+		}
+
+		if (offset <= CHUNK_SIZE || capacity == 1)
+		{
+			chunkSize = AlignUp(std::max(offset, CHUNK_SIZE), CHUNK_ALIGNMENT);
+			break;
+		}
+		capacity--;
+	}
+
+	for (size_t type : types)
+	{
+		sizes.push_back(typeSizes[type]);
+	}
+}
+
+Archetype::~Archetype()
+{
+	for (Chunk &chunk : chunks)
+	{
+		::operator delete(chunk.data, std::align_val_t(CHUNK_ALIGNMENT));
+	}
+}
+
+std::pair<size_t, size_t> Archetype::PushRow(DataEntity entity)
+{
+	if (chunks.empty() || chunks.back().count == capacity)
+	{
+		Chunk chunk;
+		chunk.data = static_cast<std::byte *>(::operator new(chunkSize, std::align_val_t(CHUNK_ALIGNMENT)));
+		chunks.push_back(chunk);
+	}
+
+	Chunk &chunk = chunks.back();
+	size_t row = chunk.count++;
+	GetEntities(chunk)[row] = entity;
+
+	return {chunks.size() - 1, row};
+}
+
+DataEntity Archetype::RemoveRow(size_t chunk, size_t row)
+{
+	Chunk &last = chunks.back();
+	size_t lastRow = last.count - 1;
+
+	// Filling the hole with the very last row keeps every chunk but the last one full.
+	DataEntity moved = GetEntities(last)[lastRow];
+	if (&chunks[chunk] != &last || row != lastRow)
+	{
+		GetEntities(chunks[chunk])[row] = moved;
+		for (size_t i = 0; i < types.size(); i++)
+		{
+			std::byte *to = static_cast<std::byte *>(GetColumn(chunks[chunk], types[i]));
+			std::byte *from = static_cast<std::byte *>(GetColumn(last, types[i]));
+			std::memcpy(to + row * sizes[i], from + lastRow * sizes[i], sizes[i]);
+		}
+	}
+
+	last.count--;
+	if (last.count == 0)
+	{
+		::operator delete(last.data, std::align_val_t(CHUNK_ALIGNMENT));
+		chunks.pop_back();
+	}
+
+	return moved;
+}
+
+size_t Archetype::Count() const
+{
+	if (chunks.empty())
+	{
+		return 0;
+	}
+
+	return (chunks.size() - 1) * capacity + chunks.back().count;
+}
+
+void ArchetypeStorage::Destroy(DataEntity entity)
+{
+	if (!IsValid(entity))
+	{
+		return;
+	}
+
+	RemoveFromArchetype(entity);
+
+	Record &record = records[entity.index];
+	record.archetype = nullptr;
+	record.generation++;
+	freeIndices.push_back(entity.index);
+}
+
+bool ArchetypeStorage::IsValid(DataEntity entity) const
+{
+	return entity.index < records.size() && records[entity.index].generation == entity.generation && records[entity.index].archetype != nullptr;
+}
+
+size_t ArchetypeStorage::Count() const
+{
+	return records.size() - freeIndices.size();
+}
+
+void ArchetypeStorage::Clear()
+{
+	// Indices are kept, with their generation bumped, so old handles stay invalid.
+	for (uint32_t index = 0; index < records.size(); index++)
+	{
+		if (records[index].archetype == nullptr)
+		{
+			continue;
+		}
+
+		records[index].archetype = nullptr;
+		records[index].generation++;
+		freeIndices.push_back(index);
+	}
+
+	archetypeMap.clear();
+	archetypes.clear();
+}
+
+void ArchetypeStorage::RegisterType(size_t type, size_t size, size_t alignment)
+{
+	if (type >= MAX_DATA_COMPONENTS)
+	{
+		Debug::LogFatalError("Too many data component types, the maximum is " + std::to_string(MAX_DATA_COMPONENTS) + ".");
+	}
+
+	sizes[type] = size;
+	alignments[type] = alignment;
+}
+
+DataEntity ArchetypeStorage::NewEntity()
+{
+	if (!freeIndices.empty())
+	{
+		uint32_t index = freeIndices.back();
+		freeIndices.pop_back();
+		return {index, records[index].generation};
+	}
+
+	records.push_back(Record());
+	return {static_cast<uint32_t>(records.size() - 1), 0};
+}
+
+Archetype *ArchetypeStorage::GetArchetype(ComponentSignature signature)
+{
+	auto it = archetypeMap.find(signature);
+	if (it != archetypeMap.end())
+	{
+		return it->second;
+	}
+
+	archetypes.push_back(std::make_unique<Archetype>(signature, sizes, alignments));
+	archetypeMap[signature] = archetypes.back().get();
+	return archetypes.back().get();
+}
+
+void ArchetypeStorage::Place(DataEntity entity, Archetype *archetype)
+{
+	std::pair<size_t, size_t> location = archetype->PushRow(entity);
+
+	Record &record = records[entity.index];
+	record.archetype = archetype;
+	record.chunk = location.first;
+	record.row = location.second;
+}
+
+void ArchetypeStorage::Move(DataEntity entity, ComponentSignature signature)
+{
+	Record &record = records[entity.index];
+	Archetype *from = record.archetype;
+	if (from->signature == signature)
+	{
+		return;
+	}
+
+	Archetype *to = GetArchetype(signature);
+	size_t fromChunk = record.chunk, fromRow = record.row;
+
+	Place(entity, to);
+
+	// Copy over the components both archetypes have, before the old row is overwritten.
+	ComponentSignature shared = from->signature & signature;
+	for (size_t type = 0; type < MAX_DATA_COMPONENTS; type++)
+	{
+		if (!shared.test(type))
+		{
+			continue;
+		}
+
+		std::byte *dst = static_cast<std::byte *>(to->GetColumn(to->chunks[record.chunk], type));
+		std::byte *src = static_cast<std::byte *>(from->GetColumn(from->chunks[fromChunk], type));
+		std::memcpy(dst + record.row * sizes[type], src + fromRow * sizes[type], sizes[type]);
+	}
+
+	DataEntity moved = from->RemoveRow(fromChunk, fromRow);
+	if (moved != entity)
+	{
+		records[moved.index].chunk = fromChunk;
+		records[moved.index].row = fromRow;
+	}
+}
+
+void ArchetypeStorage::RemoveFromArchetype(DataEntity entity)
+{
+	Record &record = records[entity.index];
+
+	DataEntity moved = record.archetype->RemoveRow(record.chunk, record.row);
+	if (moved != entity)
+	{
+		records[moved.index].chunk = record.chunk;
+		records[moved.index].row = record.row;
+	}
+}
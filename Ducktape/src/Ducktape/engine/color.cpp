@@ -189,10 +189,12 @@ const Color Color::WHITE_SMOKE = Color(245, 245, 245);
 const Color Color::YELLOW = Color(255, 255, 0);
 const Color Color::YELLOW_GREEN = Color(154, 205, 50);
 
+#ifndef DT_HEADLESS
 Color::operator sf::Color() const
 {
 	return sf::Color(red, green, blue, alpha);
 }
+#endif
 
 Color Color::Lerp(Color initialColor, Color targetColor, float delta)
 {
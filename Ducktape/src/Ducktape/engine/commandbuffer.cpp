@@ -0,0 +1,99 @@
+/*
+MIT License
+
+Copyright (c) 2022 Ducktape
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <Ducktape/engine/commandbuffer.h>
+#include <Ducktape/engine/entity.h>
+#include <Ducktape/engine/systems.h>
+
+#include <atomic>
+#include <mutex>
+using namespace DT;
+
+namespace
+{
+	std::atomic<bool> recording = false;
+	std::mutex commandsMutex;
+	std::vector<CommandBuffer::Command> commands;
+	std::vector<CommandBuffer::Command> applying;
+}
+
+bool CommandBuffer::IsRecording()
+{
+	return recording.load(std::memory_order_relaxed);
+}
+
+void CommandBuffer::Begin()
+{
+	recording = true;
+}
+
+void CommandBuffer::Record(const Command &command)
+{
+	std::lock_guard<std::mutex> lock(commandsMutex);
+	commands.push_back(command);
+}
+
+void CommandBuffer::Flush()
+{
+	recording = false;
+
+	// Swap into a second buffer kept around between frames, so that neither allocates once warm.
+	{
+		std::lock_guard<std::mutex> lock(commandsMutex);
+		applying.swap(commands);
+	}
+
+	for (const Command &command : applying)
+	{
+		switch (command.type)
+		{
+		case CommandType::RegisterComponent:
+			if (!command.component->isDestroyed)
+			{
+				command.tickList->Add(command.component);
+			}
+			break;
+		case CommandType::RemoveComponent:
+			command.entity->RemoveComponentImmediate(command.component);
+			break;
+		case CommandType::DestroyComponent:
+			command.component->DestroyImmediate();
+			break;
+		case CommandType::DestroyEntity:
+			command.entity->DestroyImmediate();
+			break;
+		}
+	}
+	applying.clear();
+
+	Systems::Compact();
+}
+
+void CommandBuffer::Clear()
+{
+	recording = false;
+
+	std::lock_guard<std::mutex> lock(commandsMutex);
+	commands.clear();
+}
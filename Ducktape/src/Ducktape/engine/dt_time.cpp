@@ -23,13 +23,21 @@ SOFTWARE.
 */
 
 #include <Ducktape/engine/dt_time.h>
+#include <Ducktape/engine/application.h>
 using namespace DT;
 
 float Time::deltaTime;
+float Time::interpolationAlpha = 1.0f;
 sf::Clock Time::clock;
 sf::Clock Time::deltaClock;
 
 void Time::Update()
 {
+	// Headless runs go as fast as they can, so frames advance simulated time rather than wall time.
+	if (Application::IsHeadless())
+	{
+		Time::deltaTime = ProjectSettings::Physics::fixedDeltaTime;
+		return;
+	}
 	Time::deltaTime = Time::deltaClock.restart().asSeconds();
 }
\ No newline at end of file
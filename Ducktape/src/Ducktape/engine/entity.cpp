@@ -26,13 +26,43 @@ SOFTWARE.
 using namespace DT;
 
 bool Entity::RemoveComponent(BehaviourScript *check)
+{
+    if (CommandBuffer::IsRecording())
+    {
+        if (check->entity != this || check->isDestroyed)
+        {
+            return false;
+        }
+        CommandBuffer::Record({CommandBuffer::CommandType::RemoveComponent, this, check});
+        return true;
+    }
+    return RemoveComponentImmediate(check);
+}
+
+bool Entity::RemoveComponentImmediate(BehaviourScript *check)
 {
     int i = 0;
     for (auto script : this->components)
     {
         if (script == check)
         {
+            Systems::Unregister(check);
             this->components.erase(this->components.begin() + i);
+
+            // Hand the slot to the next component of the same type, if there is one.
+            if (componentSlots[check->typeIndex] == check)
+            {
+                componentSlots[check->typeIndex] = nullptr;
+                componentMask.Reset(check->typeIndex);
+                for (BehaviourScript *other : components)
+                {
+                    if (other->typeIndex == check->typeIndex)
+                    {
+                        AddToSlots(other);
+                        break;
+                    }
+                }
+            }
             return true;
         }
         i++;
@@ -40,57 +70,130 @@ bool Entity::RemoveComponent(BehaviourScript *check)
     return false;
 }
 
-Entity *Entity::Find(std::string entityName)
+void Entity::AddToSlots(BehaviourScript *component)
 {
-    for (int i = 0, n = SceneManager::currentScene->entities.size(); i < n; i++)
+    if (componentMask.Test(component->typeIndex))
+    {
+        return;
+    }
+
+    if (componentSlots.size() <= component->typeIndex)
     {
-        if (SceneManager::currentScene->entities[i]->name == entityName)
+        componentSlots.resize(component->typeIndex + 1, nullptr);
+    }
+    componentSlots[component->typeIndex] = component;
+    componentMask.Set(component->typeIndex);
+}
+
+const std::string &Entity::GetName() const
+{
+    return name.ToString();
+}
+
+void Entity::SetName(std::string_view newName)
+{
+    if (scene != nullptr)
+    {
+        if (!scene->RenameEntity(this, Name(newName)))
         {
-            return SceneManager::currentScene->entities[i];
+            Debug::LogError("Cannot rename entity \"" + GetName() + "\" to \"" + std::string(newName) + "\", it is no longer in its scene.");
         }
+        return;
+    }
+    name = Name(newName);
+}
+
+Entity *Entity::Find(std::string_view entityName)
+{
+    Name entityNameId;
+    Entity *entity = nullptr;
+    if (Name::TryGet(entityName, entityNameId))
+    {
+        entity = SceneManager::currentScene->FindEntity(entityNameId);
+    }
+
+    if (entity == nullptr)
+    {
+        Debug::LogError("Entity with name \"" + std::string(entityName) + "\" doesn't exist!");
     }
-    Debug::LogError("Entity with name \"" + entityName + "\" doesn't exist!");
-    return nullptr;
+    return entity;
+}
+
+const std::vector<Entity *> &Entity::FindAll(std::string_view entityName)
+{
+    static const std::vector<Entity *> none;
+
+    // A name that was never interned can't belong to any entity.
+    Name entityNameId;
+    if (!Name::TryGet(entityName, entityNameId))
+    {
+        return none;
+    }
+    return SceneManager::currentScene->FindEntities(entityNameId);
+}
+
+Entity *Entity::Get(EntityHandle handle)
+{
+    return SceneManager::currentScene->GetEntity(handle);
+}
+
+bool Entity::IsValid(EntityHandle handle)
+{
+    return SceneManager::currentScene->IsValid(handle);
 }
 
 Entity *Entity::Instantiate(std::string entityName)
 {
-    Entity *ent = new Entity();
+    Entity *ent = Memory::GetPool<Entity>().New();
     ent->isEnabled = true;
-    ent->name = entityName;
+    ent->name = Name(entityName);
     ent->transform = ent->AddComponent<Transform>();
-    SceneManager::currentScene->entities.push_back(ent);
     ent->scene = SceneManager::currentScene;
-    Memory::heapMemory.push_back(ent);
+    ent->scene->AddEntity(ent);
     return ent;
 }
 
 Entity *Entity::Instantiate(std::string entityName, Vector2 pos, float rot, Vector2 scl)
 {
-    Entity *ent = new Entity();
+    Entity *ent = Memory::GetPool<Entity>().New();
     ent->isEnabled = true;
-    ent->name = entityName;
+    ent->name = Name(entityName);
     ent->transform = ent->AddComponent<Transform>();
     ent->transform->SetPosition(pos);
     ent->transform->SetRotation(rot);
     ent->transform->SetScale(scl);
-    SceneManager::currentScene->entities.push_back(ent);
     ent->scene = SceneManager::currentScene;
-    Memory::heapMemory.push_back(ent);
+    ent->scene->AddEntity(ent);
     return ent;
 }
 
 void Entity::Destroy()
 {
+    if (CommandBuffer::IsRecording())
+    {
+        CommandBuffer::Record({CommandBuffer::CommandType::DestroyEntity, this});
+        return;
+    }
+    DestroyImmediate();
+}
+
+void Entity::DestroyImmediate()
+{
+    if (this->isDestroyed)
+    {
+        return;
+    }
     this->isDestroyed = true;
-    for (size_t i = 0, n = SceneManager::currentScene->entities.size(); i < n; i++)
+
+    // Destroying a component removes it from the list, so go over a copy.
+    std::vector<BehaviourScript *> attached = components;
+    for (BehaviourScript *component : attached)
     {
-        if (SceneManager::currentScene->entities[i] == this)
-        {
-            SceneManager::currentScene->entities.erase(SceneManager::currentScene->entities.begin() + i);
-            break;
-        }
+        component->DestroyImmediate();
     }
+
+    scene->RemoveEntity(this);
+    Memory::Release(this);
 }
 
 void Entity::SetEnabled(bool isEnabled)
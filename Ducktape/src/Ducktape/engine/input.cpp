@@ -29,8 +29,13 @@ std::vector<KeyCode> Input::keyUpList;
 std::vector<KeyCode> Input::keyDownList;
 Vector2 Input::mousePosition;
 
-bool Input::GetMouseButton(int mouseButton)
+bool Input::GetMouseButton([[maybe_unused]] int mouseButton)
 {
+#ifndef DT_HEADLESS
+    if (Application::renderWindow == nullptr)
+    {
+        return false;
+    }
     if (mouseButton == 0 && sf::Mouse::isButtonPressed(sf::Mouse::Left))
     {
         return true;
@@ -39,12 +44,21 @@ bool Input::GetMouseButton(int mouseButton)
     {
         return true;
     }
+#endif
     return false;
 }
 
-bool Input::GetKey(KeyCode key)
+bool Input::GetKey([[maybe_unused]] KeyCode key)
 {
+#ifndef DT_HEADLESS
+    if (Application::renderWindow == nullptr)
+    {
+        return false;
+    }
     return sf::Keyboard::isKeyPressed(key);
+#else
+    return false;
+#endif
 }
 
 bool Input::GetKeyUp(KeyCode key)
@@ -62,19 +76,25 @@ void Input::Tick()
     keyUpList.clear();
     keyDownList.clear();
 
+#ifndef DT_HEADLESS
+    if (Application::renderWindow == nullptr)
+    {
+        return;
+    }
+
     std::vector<KeyCode>::iterator position;
     sf::Event event;
-    while (Application::renderWindow.pollEvent(event))
+    while (Application::renderWindow->pollEvent(event))
     {
         switch (event.type)
         {
         // window closed
         case sf::Event::Closed:
-            Application::renderWindow.close();
+            Application::renderWindow->close();
             break;
 
         case sf::Event::Resized:
-            Application::SetResolution(Vector2(Application::renderWindow.getSize().x, Application::renderWindow.getSize().y));
+            Application::SetResolution(Vector2(Application::renderWindow->getSize().x, Application::renderWindow->getSize().y));
             break;
 
         case sf::Event::KeyPressed:
@@ -91,5 +111,6 @@ void Input::Tick()
         }
     }
 
-    mousePosition = Vector2(sf::Mouse::getPosition(Application::renderWindow).x, sf::Mouse::getPosition(Application::renderWindow).y);
+    mousePosition = Vector2(sf::Mouse::getPosition(*Application::renderWindow).x, sf::Mouse::getPosition(*Application::renderWindow).y);
+#endif
 }
\ No newline at end of file
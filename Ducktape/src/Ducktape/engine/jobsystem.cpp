@@ -0,0 +1,218 @@
+/*
+MIT License
+
+Copyright (c) 2022 Ducktape
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <Ducktape/engine/jobsystem.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace DT;
+
+namespace
+{
+	struct Job
+	{
+		const std::function<void(size_t, size_t)> *func;
+		size_t begin;
+		size_t end;
+		std::atomic<size_t> *remaining;
+	};
+
+	struct WorkQueue
+	{
+		std::mutex mutex;
+		std::deque<Job> jobs;
+	};
+
+	// Queue 0 belongs to the thread calling ParallelFor, the rest to the workers.
+	std::vector<std::thread> workers;
+	std::unique_ptr<WorkQueue[]> queues;
+	size_t queueCount = 0;
+
+	std::mutex sleepMutex;
+	std::condition_variable wakeCondition;
+	std::atomic<bool> running = false;
+	std::atomic<size_t> queuedJobs = 0;
+
+	thread_local unsigned int threadIndex = 0;
+
+	bool PopJob(size_t index, Job &job)
+	{
+		WorkQueue &queue = queues[index];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.jobs.empty())
+		{
+			return false;
+		}
+		job = queue.jobs.back();
+		queue.jobs.pop_back();
+		return true;
+	}
+
+	bool StealJob(size_t thief, Job &job)
+	{
+		for (size_t i = 1; i < queueCount; i++)
+		{
+			WorkQueue &queue = queues[(thief + i) % queueCount];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			if (!queue.jobs.empty())
+			{
+				job = queue.jobs.front();
+				queue.jobs.pop_front();
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool RunNextJob(size_t index)
+	{
+		Job job;
+		if (!PopJob(index, job) && !StealJob(index, job))
+		{
+			return false;
+		}
+
+		queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+		(*job.func)(job.begin, job.end);
+		job.remaining->fetch_sub(1, std::memory_order_release);
+		return true;
+	}
+
+	void WorkerLoop(size_t index)
+	{
+		threadIndex = index;
+		while (running)
+		{
+			if (RunNextJob(index))
+			{
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(sleepMutex);
+			wakeCondition.wait(lock, [] { return !running || queuedJobs.load() > 0; });
+		}
+	}
+}
+
+void JobSystem::Init(unsigned int workerCount)
+{
+	if (running)
+	{
+		return;
+	}
+
+	if (workerCount == 0)
+	{
+		unsigned int hardwareThreads = std::thread::hardware_concurrency();
+		workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+	}
+
+	queueCount = workerCount + 1;
+	queues = std::make_unique<WorkQueue[]>(queueCount);
+	running = true;
+
+	for (size_t i = 1; i < queueCount; i++)
+	{
+		workers.emplace_back(WorkerLoop, i);
+	}
+}
+
+void JobSystem::Shutdown()
+{
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		running = false;
+	}
+	wakeCondition.notify_all();
+
+	for (std::thread &worker : workers)
+	{
+		worker.join();
+	}
+	workers.clear();
+	queues.reset();
+	queueCount = 0;
+}
+
+unsigned int JobSystem::GetWorkerCount()
+{
+	return workers.size();
+}
+
+unsigned int JobSystem::GetThreadIndex()
+{
+	return threadIndex;
+}
+
+void JobSystem::ParallelFor(size_t count, size_t chunkSize, const std::function<void(size_t, size_t)> &func)
+{
+	if (chunkSize == 0)
+	{
+		chunkSize = 1;
+	}
+
+	if (workers.empty() || count <= chunkSize)
+	{
+		if (count > 0)
+		{
+			func(0, count);
+		}
+		return;
+	}
+
+	size_t jobCount = (count + chunkSize - 1) / chunkSize;
+	std::atomic<size_t> remaining = jobCount;
+
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		queuedJobs.fetch_add(jobCount, std::memory_order_relaxed);
+	}
+
+	for (size_t i = 0; i < jobCount; i++)
+	{
+		size_t begin = i * chunkSize;
+		size_t end = std::min(begin + chunkSize, count);
+
+		WorkQueue &queue = queues[i % queueCount];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.jobs.push_back({&func, begin, end, &remaining});
+	}
+
+	wakeCondition.notify_all();
+
+	// Help out instead of idling, then wait for the chunks still running on the workers.
+	while (remaining.load(std::memory_order_acquire) > 0)
+	{
+		if (!RunNextJob(0))
+		{
+			std::this_thread::yield();
+		}
+	}
+}
@@ -0,0 +1,92 @@
+/*
+MIT License
+
+Copyright (c) 2022 Ducktape
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <Ducktape/engine/matrix3.h>
+
+#include <cmath>
+using namespace DT;
+
+Matrix3::Matrix3()
+    : m{{1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}}
+{
+}
+
+Matrix3 Matrix3::TRS(Vector2 translation, float rotation, Vector2 scale)
+{
+    float c = std::cos(rotation);
+    float s = std::sin(rotation);
+
+    Matrix3 result;
+    result.m[0][0] = c * scale.x;
+    result.m[0][1] = -s * scale.y;
+    result.m[0][2] = translation.x;
+    result.m[1][0] = s * scale.x;
+    result.m[1][1] = c * scale.y;
+    result.m[1][2] = translation.y;
+    return result;
+}
+
+Matrix3 Matrix3::operator*(const Matrix3 &other) const
+{
+    Matrix3 result;
+    for (int row = 0; row < 3; row++)
+    {
+        for (int column = 0; column < 3; column++)
+        {
+            result.m[row][column] = m[row][0] * other.m[0][column] + m[row][1] * other.m[1][column] + m[row][2] * other.m[2][column];
+        }
+    }
+    return result;
+}
+
+Vector2 Matrix3::TransformPoint(Vector2 point) const
+{
+    return Vector2(m[0][0] * point.x + m[0][1] * point.y + m[0][2], m[1][0] * point.x + m[1][1] * point.y + m[1][2]);
+}
+
+Vector2 Matrix3::TransformDirection(Vector2 direction) const
+{
+    return Vector2(m[0][0] * direction.x + m[0][1] * direction.y, m[1][0] * direction.x + m[1][1] * direction.y);
+}
+
+Matrix3 Matrix3::Inverse() const
+{
+    // Invert the 2x2 linear part, then undo the translation with it.
+    float determinant = m[0][0] * m[1][1] - m[0][1] * m[1][0];
+    float inverseDeterminant = determinant != 0.0f ? 1.0f / determinant : 0.0f;
+
+    Matrix3 result;
+    result.m[0][0] = m[1][1] * inverseDeterminant;
+    result.m[0][1] = -m[0][1] * inverseDeterminant;
+    result.m[1][0] = -m[1][0] * inverseDeterminant;
+    result.m[1][1] = m[0][0] * inverseDeterminant;
+    result.m[0][2] = -(result.m[0][0] * m[0][2] + result.m[0][1] * m[1][2]);
+    result.m[1][2] = -(result.m[1][0] * m[0][2] + result.m[1][1] * m[1][2]);
+    return result;
+}
+
+Vector2 Matrix3::GetTranslation() const
+{
+    return Vector2(m[0][2], m[1][2]);
+}
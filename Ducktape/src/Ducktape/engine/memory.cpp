@@ -25,12 +25,39 @@ SOFTWARE.
 #include <Ducktape/engine/memory.h>
 using namespace DT;
 
-std::vector<void *> Memory::heapMemory = {};
+std::vector<Memory::HeapObject> Memory::heapMemory = {};
+std::vector<Memory::PoolBase *> Memory::pools = {};
+std::vector<Memory::PendingRelease> Memory::pendingReleases = {};
+
+void Memory::ReleaseComponent(BehaviourScript *component)
+{
+    pendingReleases.push_back({component, [](void *released)
+    {
+        BehaviourScript *component = static_cast<BehaviourScript *>(released);
+        component->release(component);
+    }});
+}
+
+void Memory::FlushReleases()
+{
+    for (size_t i = 0; i < pendingReleases.size(); i++)
+    {
+        pendingReleases[i].release(pendingReleases[i].object);
+    }
+    pendingReleases.clear();
+}
 
 void Memory::Cleanup()
 {
-    for (int i = 0; i < heapMemory.size(); i++)
+    pendingReleases.clear();
+    for (PoolBase *pool : pools)
+    {
+        pool->Clear();
+    }
+
+    for (size_t i = 0; i < heapMemory.size(); i++)
     {
-        delete heapMemory[i];
+        heapMemory[i].destroy(heapMemory[i].object);
     }
+    heapMemory.clear();
 }
\ No newline at end of file
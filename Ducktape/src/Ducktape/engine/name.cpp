@@ -0,0 +1,94 @@
+/*
+MIT License
+
+Copyright (c) 2022 Ducktape
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <Ducktape/engine/name.h>
+
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+using namespace DT;
+
+namespace
+{
+	// The strings live in a deque so the views used as keys never move.
+	struct StringTable
+	{
+		std::shared_mutex mutex;
+		std::deque<std::string> strings = {""};
+		std::unordered_map<std::string_view, uint32_t> ids = {{strings[0], 0}};
+	};
+
+	StringTable &GetStringTable()
+	{
+		static StringTable table;
+		return table;
+	}
+}
+
+Name::Name(std::string_view text)
+{
+	StringTable &table = GetStringTable();
+	{
+		std::shared_lock<std::shared_mutex> lock(table.mutex);
+		auto it = table.ids.find(text);
+		if (it != table.ids.end())
+		{
+			id = it->second;
+			return;
+		}
+	}
+
+	std::unique_lock<std::shared_mutex> lock(table.mutex);
+	auto it = table.ids.find(text);
+	if (it != table.ids.end())
+	{
+		id = it->second;
+		return;
+	}
+
+	id = static_cast<uint32_t>(table.strings.size());
+	table.strings.emplace_back(text);
+	table.ids.emplace(table.strings.back(), id);
+}
+
+bool Name::TryGet(std::string_view text, Name &name)
+{
+	StringTable &table = GetStringTable();
+	std::shared_lock<std::shared_mutex> lock(table.mutex);
+	auto it = table.ids.find(text);
+	if (it == table.ids.end())
+	{
+		return false;
+	}
+	name.id = it->second;
+	return true;
+}
+
+const std::string &Name::ToString() const
+{
+	StringTable &table = GetStringTable();
+	std::shared_lock<std::shared_mutex> lock(table.mutex);
+	return table.strings[id];
+}
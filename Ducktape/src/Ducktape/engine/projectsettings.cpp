@@ -27,7 +27,30 @@ using namespace DT;
 
 std::string ProjectSettings::Application::windowTitle = "Ducktape Project";
 Vector2 ProjectSettings::Application::initialResolution = Vector2(500.0f, 500.0f);
-
-Vector2 ProjectSettings::Physics::globalGravity = Vector2(0.0f, 1.0f);
+#ifdef DT_HEADLESS
+bool ProjectSettings::Application::headless = true;
+#else
+bool ProjectSettings::Application::headless = false;
+#endif
+unsigned long long ProjectSettings::Application::maxFrames = 0;
+std::function<bool()> ProjectSettings::Application::stopCondition = nullptr;
+
+Vector2 ProjectSettings::Physics::globalGravity = Vector2(0.0f, 60.0f);
+bool ProjectSettings::Physics::fixedTimestep = false;
+float ProjectSettings::Physics::fixedDeltaTime = 1.0f / 60.0f;
+int ProjectSettings::Physics::maxStepsPerFrame = 5;
+bool ProjectSettings::Physics::parallelIslands = false;
+bool ProjectSettings::Physics::deterministic = false;
+std::array<std::string, ProjectSettings::Physics::LAYER_COUNT> ProjectSettings::Physics::layerNames = {"Default"};
+std::array<uint16_t, ProjectSettings::Physics::LAYER_COUNT> ProjectSettings::Physics::layerCollisionMatrix = []
+{
+	std::array<uint16_t, LAYER_COUNT> matrix;
+	matrix.fill(0xFFFF);
+	return matrix;
+}();
+
+bool ProjectSettings::JobSystem::parallelTicks = false;
+unsigned int ProjectSettings::JobSystem::workerCount = 0;
+size_t ProjectSettings::JobSystem::tickChunkSize = 64;
 
 Scene *ProjectSettings::SceneManagement::initialScene = nullptr;
\ No newline at end of file
@@ -23,9 +23,135 @@ SOFTWARE.
 */
 
 #include <Ducktape/engine/scene.h>
+#include <Ducktape/engine/entity.h>
 using namespace DT;
 
 void Scene::Destroy()
 {
+	for (Entity *entity : entities)
+	{
+		FreeSlot(entity->handle.index);
+	}
 	entities.clear();
+	nameIndex.clear();
+	archetypes.Clear();
+}
+
+void Scene::AddEntity(Entity *entity)
+{
+	uint32_t index;
+	if (!freeSlots.empty())
+	{
+		index = freeSlots.back();
+		freeSlots.pop_back();
+	}
+	else
+	{
+		index = static_cast<uint32_t>(entitySlots.size());
+		entitySlots.push_back(EntitySlot());
+	}
+
+	entitySlots[index].entity = entity;
+	entity->handle = {index, entitySlots[index].generation};
+	entity->sceneIndex = entities.size();
+	entities.push_back(entity);
+	IndexName(entity);
+}
+
+void Scene::RemoveEntity(Entity *entity)
+{
+	if (!IsValid(entity->handle) || entitySlots[entity->handle.index].entity != entity)
+	{
+		return;
+	}
+
+	UnindexName(entity);
+
+	// Swap and pop, patching the index of the entity that moves.
+	Entity *last = entities.back();
+	entities[entity->sceneIndex] = last;
+	last->sceneIndex = entity->sceneIndex;
+	entities.pop_back();
+
+	FreeSlot(entity->handle.index);
+}
+
+void Scene::FreeSlot(uint32_t index)
+{
+	EntitySlot &slot = entitySlots[index];
+	slot.entity = nullptr;
+	slot.generation++;
+	// A generation that wrapped around to 0 would make default handles valid, so skip it.
+	if (slot.generation == 0)
+	{
+		slot.generation = 1;
+	}
+	freeSlots.push_back(index);
+}
+
+Entity *Scene::GetEntity(EntityHandle handle) const
+{
+	if (!IsValid(handle))
+	{
+		return nullptr;
+	}
+	return entitySlots[handle.index].entity;
+}
+
+bool Scene::IsValid(EntityHandle handle) const
+{
+	return handle.index < entitySlots.size() && entitySlots[handle.index].generation == handle.generation && entitySlots[handle.index].entity != nullptr;
+}
+
+Entity *Scene::FindEntity(Name name) const
+{
+	auto it = nameIndex.find(name);
+	if (it == nameIndex.end() || it->second.empty())
+	{
+		return nullptr;
+	}
+	return it->second.front();
+}
+
+const std::vector<Entity *> &Scene::FindEntities(Name name) const
+{
+	static const std::vector<Entity *> none;
+
+	auto it = nameIndex.find(name);
+	if (it == nameIndex.end())
+	{
+		return none;
+	}
+	return it->second;
+}
+
+bool Scene::RenameEntity(Entity *entity, Name newName)
+{
+	if (!IsValid(entity->handle) || entitySlots[entity->handle.index].entity != entity)
+	{
+		return false;
+	}
+
+	UnindexName(entity);
+	entity->name = newName;
+	IndexName(entity);
+	return true;
+}
+
+void Scene::IndexName(Entity *entity)
+{
+	std::vector<Entity *> &bucket = nameIndex[entity->name];
+	entity->nameIndex = bucket.size();
+	bucket.push_back(entity);
+}
+
+void Scene::UnindexName(Entity *entity)
+{
+	// Swap and pop within the bucket, so that despawning many entities with the same name
+	// stays linear.
+	std::vector<Entity *> &bucket = nameIndex[entity->name];
+	Entity *last = bucket.back();
+	bucket[entity->nameIndex] = last;
+	last->nameIndex = entity->nameIndex;
+	bucket.pop_back();
 }
\ No newline at end of file
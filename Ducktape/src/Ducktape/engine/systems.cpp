@@ -0,0 +1,138 @@
+/*
+MIT License
+
+Copyright (c) 2022 Ducktape
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <Ducktape/engine/systems.h>
+#include <Ducktape/engine/entity.h>
+#include <Ducktape/engine/jobsystem.h>
+#include <Ducktape/engine/projectsettings.h>
+using namespace DT;
+
+std::vector<TickList *> Systems::tickLists;
+
+void TickList::Add(BehaviourScript *component)
+{
+	component->tickList = this;
+	component->tickIndex = components.size();
+	components.push_back(component);
+}
+
+void TickList::Remove(BehaviourScript *component)
+{
+	components[component->tickIndex] = nullptr;
+	component->tickList = nullptr;
+	needsCompaction = true;
+}
+
+void TickList::Tick(size_t begin, size_t end)
+{
+	for (size_t i = begin; i < end; i++)
+	{
+		BehaviourScript *component = components[i];
+		if (component != nullptr && component->isEnabled && component->entity->isEnabled)
+		{
+			tick(component);
+		}
+	}
+}
+
+void TickList::Compact()
+{
+	size_t count = 0;
+	for (size_t i = 0, n = components.size(); i < n; i++)
+	{
+		if (components[i] != nullptr)
+		{
+			components[count] = components[i];
+			components[count]->tickIndex = count;
+			count++;
+		}
+	}
+	components.resize(count);
+	needsCompaction = false;
+}
+
+void Systems::Unregister(BehaviourScript *component)
+{
+	if (component->tickList != nullptr)
+	{
+		component->tickList->Remove(component);
+	}
+}
+
+void Systems::Tick()
+{
+	bool parallelTicks = ProjectSettings::JobSystem::parallelTicks;
+
+	if (parallelTicks)
+	{
+		for (size_t i = 0; i < tickLists.size(); i++)
+		{
+			TickList *list = tickLists[i];
+			if (list->parallelSafe)
+			{
+				// ParallelFor returns once every chunk is done, which keeps parallel ticks
+				// from overlapping the main thread ticks and the physics step.
+				JobSystem::ParallelFor(list->components.size(), ProjectSettings::JobSystem::tickChunkSize, [list](size_t begin, size_t end) { list->Tick(begin, end); });
+			}
+		}
+	}
+
+	// Getting the tick list of a type added during a tick may create a new list, so the size is
+	// read every iteration.
+	for (size_t i = 0; i < tickLists.size(); i++)
+	{
+		TickList *list = tickLists[i];
+		if (!parallelTicks || !list->parallelSafe)
+		{
+			list->Tick(0, list->components.size());
+		}
+	}
+}
+
+void Systems::Compact()
+{
+	for (TickList *list : tickLists)
+	{
+		if (list->needsCompaction)
+		{
+			list->Compact();
+		}
+	}
+}
+
+void Systems::Clear()
+{
+	for (TickList *list : tickLists)
+	{
+		for (BehaviourScript *component : list->components)
+		{
+			if (component != nullptr)
+			{
+				component->tickList = nullptr;
+			}
+		}
+		list->components.clear();
+		list->needsCompaction = false;
+	}
+}
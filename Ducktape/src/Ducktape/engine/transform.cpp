@@ -30,122 +30,258 @@ void Transform::OnTransformChange()
     Rigidbody2D *rb = entity->GetComponent<Rigidbody2D>();
     if (rb != nullptr)
     {
-        rb->body->SetTransform((b2Vec2)entity->transform->SetPosition(), entity->transform->GetRotation());
+        rb->body->SetTransform((b2Vec2)GetPosition(), GetRotation());
     }
 }
 
-Vector2 Transform::SetPosition()
+void Transform::MarkDirty()
 {
-    return position;
+    localDirty = true;
+    MarkWorldDirty();
 }
 
-float Transform::GetRotation()
+void Transform::MarkWorldDirty()
 {
-    return rotation;
+    // A dirty transform always has dirty children, so the walk stops at the first one that's
+    // already dirty.
+    if (worldDirty)
+    {
+        return;
+    }
+    worldDirty = true;
+    TransformHierarchy::MarkTransformsDirty();
+
+    for (Transform *child : children)
+    {
+        child->MarkWorldDirty();
+    }
 }
 
-Vector2 Transform::GetScale()
+void Transform::UpdateWorld()
 {
-    return scale;
+    if (!worldDirty)
+    {
+        return;
+    }
+
+    const Matrix3 &local = GetLocalMatrix();
+    if (parent != nullptr)
+    {
+        parent->UpdateWorld();
+        worldMatrix = parent->worldMatrix * local;
+        rotation = parent->rotation + localRotation;
+        scale = Vector2(parent->scale.x * localScale.x, parent->scale.y * localScale.y);
+    }
+    else
+    {
+        worldMatrix = local;
+        rotation = localRotation;
+        scale = localScale;
+    }
+    position = worldMatrix.GetTranslation();
+    worldDirty = false;
 }
 
-// local versions of each method
+void Transform::Constructor()
+{
+    TransformHierarchy::Add(this);
+}
 
-Vector2 Transform::GetLocalPosition()
+void Transform::OnDestroy()
 {
-    return localPosition;
+    // Children outlive their parent, keeping where they are in the world.
+    while (!children.empty())
+    {
+        children.back()->SetParent(nullptr);
+    }
+    SetParent(nullptr);
+    TransformHierarchy::Remove(this);
 }
 
-float Transform::GetLocalRotation()
+Transform *Transform::GetParent()
 {
-    return localRotation;
+    return parent;
 }
 
-Vector2 Transform::GetLocalScale()
+const std::vector<Transform *> &Transform::GetChildren()
 {
-    return localScale;
+    return children;
 }
 
-void Transform::RecalculateLocalValues()
+void Transform::SetParent(Transform *newParent, bool keepWorldValues)
 {
-    Vector2 _pos;
-    float _rot;
-    Vector2 _scl;
+    if (newParent == parent)
+    {
+        return;
+    }
 
-    Transform *currentParent = this->parent;
+    Vector2 worldPosition = GetPosition();
+    float worldRotation = GetRotation();
+    Vector2 worldScale = GetScale();
 
-    while (currentParent != nullptr)
+    if (parent != nullptr)
+    {
+        parent->children.erase(std::remove(parent->children.begin(), parent->children.end(), this), parent->children.end());
+    }
+    parent = newParent;
+    if (parent != nullptr)
     {
-        _pos = _pos + currentParent->GetLocalPosition();
-        _rot = _rot + currentParent->GetLocalRotation();
-        _scl = _scl + currentParent->GetLocalScale();
-        currentParent = currentParent->parent;
+        parent->children.push_back(this);
     }
+    TransformHierarchy::MarkStructureDirty();
+    MarkWorldDirty();
 
-    localPosition = position - _pos;
-    localRotation = rotation - _rot;
-    localScale = scale - _scl;
+    if (keepWorldValues)
+    {
+        SetScale(worldScale);
+        SetRotation(worldRotation);
+        SetPosition(worldPosition);
+    }
 }
 
-void Transform::RecalculateWorldValues()
+const Matrix3 &Transform::GetLocalMatrix()
 {
-    Vector2 _pos;
-    float _rot;
-    Vector2 _scl;
+    if (localDirty)
+    {
+        localMatrix = Matrix3::TRS(localPosition, localRotation, localScale);
+        localDirty = false;
+    }
+    return localMatrix;
+}
 
-    Transform *currentParent;
+const Matrix3 &Transform::GetWorldMatrix()
+{
+    UpdateWorld();
+    return worldMatrix;
+}
 
-    while (currentParent != nullptr)
+Vector2 Transform::GetPosition()
+{
+    UpdateWorld();
+    return position;
+}
+
+Vector2 Transform::SetPosition()
+{
+    return GetPosition();
+}
+
+float Transform::GetRotation()
+{
+    UpdateWorld();
+    return rotation;
+}
+
+Vector2 Transform::GetScale()
+{
+    UpdateWorld();
+    return scale;
+}
+
+Vector2 Transform::GetInterpolatedPosition()
+{
+    if (!hasPreviousState)
     {
-        _pos = _pos + currentParent->GetLocalPosition();
-        _rot = _rot + currentParent->GetLocalRotation();
-        _scl = _scl + currentParent->GetLocalScale();
-        currentParent = currentParent->parent;
+        return GetPosition();
     }
+    return Vector2::Lerp(previousPosition, GetPosition(), Time::interpolationAlpha);
+}
+
+float Transform::GetInterpolatedRotation()
+{
+    if (!hasPreviousState)
+    {
+        return GetRotation();
+    }
+    return Mathf::Lerp(previousRotation, GetRotation(), Time::interpolationAlpha);
+}
+
+void Transform::StorePreviousState(Vector2 prevPosition, float prevRotation)
+{
+    previousPosition = prevPosition;
+    previousRotation = prevRotation;
+    hasPreviousState = true;
+}
+
+// local versions of each method
 
-    position = _pos;
-    rotation = _rot;
-    scale = _scl;
+Vector2 Transform::GetLocalPosition()
+{
+    return localPosition;
+}
+
+float Transform::GetLocalRotation()
+{
+    return localRotation;
+}
+
+Vector2 Transform::GetLocalScale()
+{
+    return localScale;
 }
 
 void Transform::SetPosition(Vector2 newPosition)
 {
-    position = newPosition;
+    localPosition = parent != nullptr ? parent->GetWorldMatrix().Inverse().TransformPoint(newPosition) : newPosition;
+    hasPreviousState = false;
+    MarkDirty();
     OnTransformChange();
-    RecalculateLocalValues();
 }
 
 void Transform::SetRotation(float newRotation)
 {
-    rotation = newRotation;
+    localRotation = parent != nullptr ? newRotation - parent->GetRotation() : newRotation;
+    hasPreviousState = false;
+    MarkDirty();
     OnTransformChange();
-    RecalculateLocalValues();
 }
 
 void Transform::SetScale(Vector2 newScale)
 {
-    scale = newScale;
+    if (parent != nullptr)
+    {
+        Vector2 parentScale = parent->GetScale();
+        newScale = Vector2(parentScale.x != 0.0f ? newScale.x / parentScale.x : 0.0f, parentScale.y != 0.0f ? newScale.y / parentScale.y : 0.0f);
+    }
+    localScale = newScale;
+    MarkDirty();
     OnTransformChange();
-    RecalculateLocalValues();
+}
+
+void Transform::SetPoseFromPhysics(Vector2 newPosition, float newRotation)
+{
+    if (parent != nullptr)
+    {
+        localPosition = parent->GetWorldMatrix().Inverse().TransformPoint(newPosition);
+        localRotation = newRotation - parent->GetRotation();
+    }
+    else
+    {
+        localPosition = newPosition;
+        localRotation = newRotation;
+    }
+    MarkDirty();
 }
 
 void Transform::SetLocalPosition(Vector2 newLocalPosition)
 {
-    position = newLocalPosition;
+    localPosition = newLocalPosition;
+    hasPreviousState = false;
+    MarkDirty();
     OnTransformChange();
-    RecalculateWorldValues();
 }
 
 void Transform::SetLocalRotation(float newLocalRotation)
 {
-    rotation = newLocalRotation;
+    localRotation = newLocalRotation;
+    hasPreviousState = false;
+    MarkDirty();
     OnTransformChange();
-    RecalculateWorldValues();
 }
 
 void Transform::SetLocalScale(Vector2 newLocalScale)
 {
-    scale = newLocalScale;
+    localScale = newLocalScale;
+    MarkDirty();
     OnTransformChange();
-    RecalculateWorldValues();
-}
\ No newline at end of file
+}
@@ -0,0 +1,327 @@
+/*
+MIT License
+
+Copyright (c) 2022 Ducktape
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <Ducktape/engine/transformhierarchy.h>
+#include <Ducktape/engine/transform.h>
+#include <Ducktape/engine/jobsystem.h>
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DT_TRANSFORM_SSE
+#include <emmintrin.h>
+#endif
+
+using namespace DT;
+
+namespace
+{
+    // The values stored per transform. The matrices are affine, so only their top two rows are kept.
+    enum Value
+    {
+        A,
+        B,
+        TX,
+        C,
+        D,
+        TY,
+        ROTATION,
+        SCALE_X,
+        SCALE_Y,
+        VALUE_COUNT
+    };
+
+#ifdef DT_TRANSFORM_SSE
+    inline __m128 GatherParents(const std::vector<float> &values, const int32_t *parents)
+    {
+        return _mm_setr_ps(values[parents[0]], values[parents[1]], values[parents[2]], values[parents[3]]);
+    }
+
+    inline void StoreMasked(std::vector<float> &values, size_t i, __m128 newValues, __m128 mask)
+    {
+        __m128 oldValues = _mm_loadu_ps(&values[i]);
+        _mm_storeu_ps(&values[i], _mm_or_ps(_mm_and_ps(mask, newValues), _mm_andnot_ps(mask, oldValues)));
+    }
+#endif
+}
+
+std::vector<Transform *> TransformHierarchy::transforms;
+std::vector<Transform *> TransformHierarchy::order;
+std::vector<size_t> TransformHierarchy::depthStarts;
+std::vector<int32_t> TransformHierarchy::parents;
+std::vector<uint8_t> TransformHierarchy::dirty;
+std::vector<float> TransformHierarchy::local[9];
+std::vector<float> TransformHierarchy::world[9];
+bool TransformHierarchy::structureDirty = false;
+std::atomic<bool> TransformHierarchy::transformsDirty = false;
+
+void TransformHierarchy::Add(Transform *transform)
+{
+    transform->hierarchySlot = transforms.size();
+    transforms.push_back(transform);
+    structureDirty = true;
+    transformsDirty = true;
+}
+
+void TransformHierarchy::Remove(Transform *transform)
+{
+    size_t slot = transform->hierarchySlot;
+    if (slot >= transforms.size() || transforms[slot] != transform)
+    {
+        return;
+    }
+
+    transforms[slot] = transforms.back();
+    transforms[slot]->hierarchySlot = slot;
+    transforms.pop_back();
+    structureDirty = true;
+}
+
+void TransformHierarchy::MarkStructureDirty()
+{
+    structureDirty = true;
+}
+
+void TransformHierarchy::MarkTransformsDirty()
+{
+    transformsDirty.store(true, std::memory_order_relaxed);
+}
+
+void TransformHierarchy::Clear()
+{
+    transforms.clear();
+    order.clear();
+    depthStarts.clear();
+    parents.clear();
+    dirty.clear();
+    structureDirty = false;
+    transformsDirty = false;
+}
+
+void TransformHierarchy::Rebuild()
+{
+    // Breadth first from the roots, which lays the transforms out one whole depth after another.
+    order.clear();
+    depthStarts.clear();
+    parents.clear();
+
+    for (Transform *transform : transforms)
+    {
+        if (transform->parent == nullptr)
+        {
+            order.push_back(transform);
+            parents.push_back(-1);
+        }
+    }
+
+    size_t depthStart = 0;
+    while (depthStart < order.size())
+    {
+        depthStarts.push_back(depthStart);
+        size_t depthEnd = order.size();
+        for (size_t i = depthStart; i < depthEnd; i++)
+        {
+            for (Transform *child : order[i]->children)
+            {
+                order.push_back(child);
+                parents.push_back((int32_t)i);
+            }
+        }
+        depthStart = depthEnd;
+    }
+    depthStarts.push_back(order.size());
+
+    dirty.resize(order.size());
+    for (size_t value = 0; value < VALUE_COUNT; value++)
+    {
+        local[value].resize(order.size());
+        world[value].resize(order.size());
+    }
+
+    structureDirty = false;
+}
+
+void TransformHierarchy::Gather()
+{
+    JobSystem::ParallelFor(order.size(), CHUNK_SIZE, [](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; i++)
+        {
+            Transform *transform = order[i];
+            dirty[i] = transform->worldDirty;
+
+            // Clean transforms only pass their world values on to their children, while dirty ones
+            // need their local values to recalculate from. Dirty roots are already done.
+            if (transform->worldDirty)
+            {
+                const Matrix3 &matrix = transform->GetLocalMatrix();
+                std::vector<float> *target = parents[i] < 0 ? world : local;
+                target[A][i] = matrix.m[0][0];
+                target[B][i] = matrix.m[0][1];
+                target[TX][i] = matrix.m[0][2];
+                target[C][i] = matrix.m[1][0];
+                target[D][i] = matrix.m[1][1];
+                target[TY][i] = matrix.m[1][2];
+                target[ROTATION][i] = transform->localRotation;
+                target[SCALE_X][i] = transform->localScale.x;
+                target[SCALE_Y][i] = transform->localScale.y;
+            }
+            else
+            {
+                world[A][i] = transform->worldMatrix.m[0][0];
+                world[B][i] = transform->worldMatrix.m[0][1];
+                world[TX][i] = transform->worldMatrix.m[0][2];
+                world[C][i] = transform->worldMatrix.m[1][0];
+                world[D][i] = transform->worldMatrix.m[1][1];
+                world[TY][i] = transform->worldMatrix.m[1][2];
+                world[ROTATION][i] = transform->rotation;
+                world[SCALE_X][i] = transform->scale.x;
+                world[SCALE_Y][i] = transform->scale.y;
+            }
+        }
+    });
+}
+
+void TransformHierarchy::Propagate(size_t begin, size_t end)
+{
+    size_t i = begin;
+
+#ifdef DT_TRANSFORM_SSE
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 4 <= end; i += 4)
+    {
+        uint32_t anyDirty;
+        std::memcpy(&anyDirty, &dirty[i], sizeof(anyDirty));
+        if (anyDirty == 0)
+        {
+            continue;
+        }
+
+        __m128 mask = _mm_castsi128_ps(_mm_cmpgt_epi32(_mm_setr_epi32(dirty[i], dirty[i + 1], dirty[i + 2], dirty[i + 3]), zero));
+        const int32_t *parentIndices = &parents[i];
+
+        __m128 pa = GatherParents(world[A], parentIndices);
+        __m128 pb = GatherParents(world[B], parentIndices);
+        __m128 ptx = GatherParents(world[TX], parentIndices);
+        __m128 pc = GatherParents(world[C], parentIndices);
+        __m128 pd = GatherParents(world[D], parentIndices);
+        __m128 pty = GatherParents(world[TY], parentIndices);
+
+        __m128 la = _mm_loadu_ps(&local[A][i]);
+        __m128 lb = _mm_loadu_ps(&local[B][i]);
+        __m128 ltx = _mm_loadu_ps(&local[TX][i]);
+        __m128 lc = _mm_loadu_ps(&local[C][i]);
+        __m128 ld = _mm_loadu_ps(&local[D][i]);
+        __m128 lty = _mm_loadu_ps(&local[TY][i]);
+
+        StoreMasked(world[A], i, _mm_add_ps(_mm_mul_ps(pa, la), _mm_mul_ps(pb, lc)), mask);
+        StoreMasked(world[B], i, _mm_add_ps(_mm_mul_ps(pa, lb), _mm_mul_ps(pb, ld)), mask);
+        StoreMasked(world[TX], i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(pa, ltx), _mm_mul_ps(pb, lty)), ptx), mask);
+        StoreMasked(world[C], i, _mm_add_ps(_mm_mul_ps(pc, la), _mm_mul_ps(pd, lc)), mask);
+        StoreMasked(world[D], i, _mm_add_ps(_mm_mul_ps(pc, lb), _mm_mul_ps(pd, ld)), mask);
+        StoreMasked(world[TY], i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(pc, ltx), _mm_mul_ps(pd, lty)), pty), mask);
+
+        StoreMasked(world[ROTATION], i, _mm_add_ps(GatherParents(world[ROTATION], parentIndices), _mm_loadu_ps(&local[ROTATION][i])), mask);
+        StoreMasked(world[SCALE_X], i, _mm_mul_ps(GatherParents(world[SCALE_X], parentIndices), _mm_loadu_ps(&local[SCALE_X][i])), mask);
+        StoreMasked(world[SCALE_Y], i, _mm_mul_ps(GatherParents(world[SCALE_Y], parentIndices), _mm_loadu_ps(&local[SCALE_Y][i])), mask);
+    }
+#endif
+
+    for (; i < end; i++)
+    {
+        if (!dirty[i])
+        {
+            continue;
+        }
+
+        int32_t p = parents[i];
+        world[A][i] = world[A][p] * local[A][i] + world[B][p] * local[C][i];
+        world[B][i] = world[A][p] * local[B][i] + world[B][p] * local[D][i];
+        world[TX][i] = world[A][p] * local[TX][i] + world[B][p] * local[TY][i] + world[TX][p];
+        world[C][i] = world[C][p] * local[A][i] + world[D][p] * local[C][i];
+        world[D][i] = world[C][p] * local[B][i] + world[D][p] * local[D][i];
+        world[TY][i] = world[C][p] * local[TX][i] + world[D][p] * local[TY][i] + world[TY][p];
+        world[ROTATION][i] = world[ROTATION][p] + local[ROTATION][i];
+        world[SCALE_X][i] = world[SCALE_X][p] * local[SCALE_X][i];
+        world[SCALE_Y][i] = world[SCALE_Y][p] * local[SCALE_Y][i];
+    }
+}
+
+void TransformHierarchy::Scatter()
+{
+    JobSystem::ParallelFor(order.size(), CHUNK_SIZE, [](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; i++)
+        {
+            if (!dirty[i])
+            {
+                continue;
+            }
+
+            Transform *transform = order[i];
+            transform->worldMatrix.m[0][0] = world[A][i];
+            transform->worldMatrix.m[0][1] = world[B][i];
+            transform->worldMatrix.m[0][2] = world[TX][i];
+            transform->worldMatrix.m[1][0] = world[C][i];
+            transform->worldMatrix.m[1][1] = world[D][i];
+            transform->worldMatrix.m[1][2] = world[TY][i];
+            transform->worldMatrix.m[2][0] = 0.0f;
+            transform->worldMatrix.m[2][1] = 0.0f;
+            transform->worldMatrix.m[2][2] = 1.0f;
+            transform->position = Vector2(world[TX][i], world[TY][i]);
+            transform->rotation = world[ROTATION][i];
+            transform->scale = Vector2(world[SCALE_X][i], world[SCALE_Y][i]);
+            transform->worldDirty = false;
+        }
+    });
+}
+
+void TransformHierarchy::Update()
+{
+    if (structureDirty)
+    {
+        Rebuild();
+    }
+    else if (!transformsDirty.load(std::memory_order_relaxed))
+    {
+        return;
+    }
+    transformsDirty = false;
+
+    Gather();
+
+    // Every depth only reads the one before it, so the transforms of a single depth can be split
+    // freely between jobs. Chunks stay a multiple of four so the SSE groups never straddle them.
+    for (size_t depth = 1; depth + 1 < depthStarts.size(); depth++)
+    {
+        size_t depthStart = depthStarts[depth];
+        size_t depthCount = depthStarts[depth + 1] - depthStart;
+        JobSystem::ParallelFor(depthCount, CHUNK_SIZE, [depthStart](size_t begin, size_t end)
+        {
+            Propagate(depthStart + begin, depthStart + end);
+        });
+    }
+
+    Scatter();
+}
\ No newline at end of file
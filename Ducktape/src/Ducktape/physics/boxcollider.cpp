@@ -32,18 +32,27 @@ void BoxCollider2D::Constructor()
     {
         rb = entity->AddComponent<Rigidbody2D>();
     }
+    rb->attachments.push_back(this);
 
     b2PolygonShape collisionShape;
+    collisionShape.SetAsBox(GetScale().x * entity->transform->GetScale().x, GetScale().y * entity->transform->GetScale().y);
+
     b2FixtureDef fixtureDef;
+    fixtureDef.filter = Physics::GetLayerFilter(layer);
     fixtureDef.shape = &collisionShape;
     fixture = rb->body->CreateFixture(&fixtureDef);
 }
 
-void BoxCollider2D::Tick()
+void BoxCollider2D::OnDestroy()
 {
-    if (rb->isDestroyed)
+    // When the rigidbody itself is being destroyed, the fixture goes along with its body.
+    if (!rb->isDestroyed)
     {
-        Destroy();
+        if (fixture != nullptr)
+        {
+            rb->body->DestroyFixture(fixture);
+        }
+        rb->Detach(this);
     }
 }
 
@@ -71,22 +80,16 @@ void BoxCollider2D::SetScale(Vector2 val)
 {
     scale = val;
 
-    b2PolygonShape collisionShape;
-    collisionShape.SetAsBox(GetScale().x * entity->transform->GetScale().x, GetScale().y * entity->transform->GetScale().y);
-
-    b2FixtureDef fixtureDef;
-    fixtureDef.shape = &collisionShape;
-    fixtureDef.density = GetDensity();
-    fixtureDef.friction = GetFriction();
-    fixtureDef.isSensor = GetIsTrigger();
-
-    rb->body->DestroyFixture(fixture);
-    fixture = rb->body->CreateFixture(&fixtureDef);
+    // The shape is edited in place, so the fixture and its proxy are kept.
+    b2PolygonShape *collisionShape = static_cast<b2PolygonShape *>(fixture->GetShape());
+    collisionShape->SetAsBox(GetScale().x * entity->transform->GetScale().x, GetScale().y * entity->transform->GetScale().y);
+    rb->MarkShapesDirty();
 }
 
 void BoxCollider2D::SetDensity(float val)
 {
     fixture->SetDensity(val);
+    rb->MarkShapesDirty();
 }
 
 void BoxCollider2D::SetFriction(float val)
@@ -97,4 +100,33 @@ void BoxCollider2D::SetFriction(float val)
 void BoxCollider2D::SetIsTrigger(bool val)
 {
     fixture->SetSensor(val);
+}
+
+int BoxCollider2D::GetLayer()
+{
+    return layer;
+}
+
+void BoxCollider2D::SetLayer(int val)
+{
+    if (val < 0 || val >= ProjectSettings::Physics::LAYER_COUNT)
+    {
+        Debug::LogError("The layer of a collider must be >= 0 and < " + std::to_string(ProjectSettings::Physics::LAYER_COUNT) + ", the layer chosen is " + std::to_string(val));
+        return;
+    }
+
+    layer = val;
+    if (fixture != nullptr)
+    {
+        fixture->SetFilterData(Physics::GetLayerFilter(layer));
+    }
+}
+
+void BoxCollider2D::SetLayer(std::string_view layerName)
+{
+    int val = Physics::GetLayer(layerName);
+    if (val >= 0)
+    {
+        SetLayer(val);
+    }
 }
\ No newline at end of file
@@ -32,21 +32,29 @@ void CircleCollider2D::Constructor()
     {
         rb = entity->AddComponent<Rigidbody2D>();
     }
+    rb->attachments.push_back(this);
 
     b2CircleShape circleShape;
 
     circleShape.m_p.Set(0.0f, 0.0f);
+    circleShape.m_radius = GetRadius();
 
     b2FixtureDef fixtureDef;
+    fixtureDef.filter = Physics::GetLayerFilter(layer);
     fixtureDef.shape = &circleShape;
     fixture = rb->body->CreateFixture(&fixtureDef);
 }
 
-void CircleCollider2D::Tick()
+void CircleCollider2D::OnDestroy()
 {
-    if (rb->isDestroyed)
+    // When the rigidbody itself is being destroyed, the fixture goes along with its body.
+    if (!rb->isDestroyed)
     {
-        Destroy();
+        if (fixture != nullptr)
+        {
+            rb->body->DestroyFixture(fixture);
+        }
+        rb->Detach(this);
     }
 }
 
@@ -74,24 +82,15 @@ void CircleCollider2D::SetRadius(float val)
 {
     radius = val;
 
-    b2CircleShape circleShape;
-
-    circleShape.m_p.Set(0.0f, 0.0f);
-    circleShape.m_radius = GetRadius();
-
-    b2FixtureDef fixtureDef;
-    fixtureDef.shape = &circleShape;
-    fixtureDef.density = GetDensity();
-    fixtureDef.friction = GetFriction();
-    fixtureDef.isSensor = GetIsTrigger();
-
-    rb->body->DestroyFixture(fixture);
-    fixture = rb->body->CreateFixture(&fixtureDef);
+    // The shape is edited in place, so the fixture and its proxy are kept.
+    fixture->GetShape()->m_radius = GetRadius();
+    rb->MarkShapesDirty();
 }
 
 void CircleCollider2D::SetDensity(float val)
 {
     fixture->SetDensity(val);
+    rb->MarkShapesDirty();
 }
 
 void CircleCollider2D::SetFriction(float val)
@@ -102,4 +101,33 @@ void CircleCollider2D::SetFriction(float val)
 void CircleCollider2D::SetIsTrigger(bool val)
 {
     fixture->SetSensor(val);
+}
+
+int CircleCollider2D::GetLayer()
+{
+    return layer;
+}
+
+void CircleCollider2D::SetLayer(int val)
+{
+    if (val < 0 || val >= ProjectSettings::Physics::LAYER_COUNT)
+    {
+        Debug::LogError("The layer of a collider must be >= 0 and < " + std::to_string(ProjectSettings::Physics::LAYER_COUNT) + ", the layer chosen is " + std::to_string(val));
+        return;
+    }
+
+    layer = val;
+    if (fixture != nullptr)
+    {
+        fixture->SetFilterData(Physics::GetLayerFilter(layer));
+    }
+}
+
+void CircleCollider2D::SetLayer(std::string_view layerName)
+{
+    int val = Physics::GetLayer(layerName);
+    if (val >= 0)
+    {
+        SetLayer(val);
+    }
 }
\ No newline at end of file
@@ -0,0 +1,417 @@
+/*
+MIT License
+
+Copyright (c) 2022 Ducktape
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <Ducktape/physics/convexdecomposition.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <numeric>
+#include <unordered_map>
+
+#include <box2d/box2d.h>
+using namespace DT;
+
+namespace
+{
+	struct CachedDecomposition
+	{
+		std::vector<Vector2> points;
+		std::shared_ptr<const ConvexDecomposition::Pieces> pieces;
+	};
+
+	struct DecompositionCache
+	{
+		std::mutex mutex;
+		std::unordered_map<uint64_t, CachedDecomposition> entries;
+	};
+
+	DecompositionCache &GetCache()
+	{
+		static DecompositionCache cache;
+		return cache;
+	}
+
+	// FNV-1a over the bits of the coordinates.
+	uint64_t HashPoints(const std::vector<Vector2> &points)
+	{
+		uint64_t hash = 14695981039346656037ull;
+		for (const Vector2 &point : points)
+		{
+			float coordinates[2] = {point.x, point.y};
+			unsigned char bytes[sizeof(coordinates)];
+			std::memcpy(bytes, coordinates, sizeof(coordinates));
+
+			for (unsigned char byte : bytes)
+			{
+				hash ^= byte;
+				hash *= 1099511628211ull;
+			}
+		}
+		return hash;
+	}
+
+	bool SamePoints(const std::vector<Vector2> &a, const std::vector<Vector2> &b)
+	{
+		if (a.size() != b.size())
+		{
+			return false;
+		}
+
+		for (size_t i = 0; i < a.size(); i++)
+		{
+			if (a[i].x != b[i].x || a[i].y != b[i].y)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Twice the signed area of the triangle abc, positive when it's counter-clockwise.
+	float Orient(const b2Vec2 &a, const b2Vec2 &b, const b2Vec2 &c)
+	{
+		return b2Cross(b - a, c - a);
+	}
+
+	// Drops repeated and collinear points, which Box2D would weld anyway, and makes the winding
+	// counter-clockwise.
+	std::vector<b2Vec2> Prepare(const std::vector<Vector2> &points)
+	{
+		const float weldDistanceSquared = b2_linearSlop * b2_linearSlop;
+
+		std::vector<b2Vec2> vertices;
+		for (const Vector2 &point : points)
+		{
+			b2Vec2 vertex(point.x, point.y);
+			if (vertices.empty() || b2DistanceSquared(vertex, vertices.back()) > weldDistanceSquared)
+			{
+				vertices.push_back(vertex);
+			}
+		}
+
+		while (vertices.size() > 1 && b2DistanceSquared(vertices.front(), vertices.back()) <= weldDistanceSquared)
+		{
+			vertices.pop_back();
+		}
+
+		bool removed = true;
+		while (removed && vertices.size() >= 3)
+		{
+			removed = false;
+			for (size_t i = 0, n = vertices.size(); i < n; i++)
+			{
+				const b2Vec2 &prev = vertices[(i + n - 1) % n];
+				const b2Vec2 &next = vertices[(i + 1) % n];
+
+				// The distance of the point from the line through its neighbours.
+				if (std::abs(Orient(prev, vertices[i], next)) <= 0.5f * b2_linearSlop * b2Distance(prev, next))
+				{
+					vertices.erase(vertices.begin() + i);
+					removed = true;
+					break;
+				}
+			}
+		}
+
+		float area = 0.0f;
+		for (size_t i = 0, n = vertices.size(); i < n; i++)
+		{
+			area += b2Cross(vertices[i], vertices[(i + 1) % n]);
+		}
+
+		if (area < 0.0f)
+		{
+			std::reverse(vertices.begin(), vertices.end());
+		}
+		return vertices;
+	}
+
+	bool IsEar(const std::vector<b2Vec2> &vertices, const std::vector<int> &remaining, size_t i)
+	{
+		size_t n = remaining.size();
+		int prev = remaining[(i + n - 1) % n];
+		int cur = remaining[i];
+		int next = remaining[(i + 1) % n];
+
+		const b2Vec2 &a = vertices[prev];
+		const b2Vec2 &b = vertices[cur];
+		const b2Vec2 &c = vertices[next];
+
+		if (Orient(a, b, c) <= 0.0f)
+		{
+			return false;
+		}
+
+		for (int index : remaining)
+		{
+			if (index == prev || index == cur || index == next)
+			{
+				continue;
+			}
+
+			const b2Vec2 &p = vertices[index];
+			if (Orient(a, b, p) >= 0.0f && Orient(b, c, p) >= 0.0f && Orient(c, a, p) >= 0.0f)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Ear clipping, the triangles are counter-clockwise lists of indices into vertices.
+	bool Triangulate(const std::vector<b2Vec2> &vertices, std::vector<std::vector<int>> &triangles)
+	{
+		std::vector<int> remaining(vertices.size());
+		std::iota(remaining.begin(), remaining.end(), 0);
+
+		size_t i = 0;
+		size_t misses = 0;
+		while (remaining.size() > 3)
+		{
+			size_t n = remaining.size();
+			if (IsEar(vertices, remaining, i))
+			{
+				triangles.push_back({remaining[(i + n - 1) % n], remaining[i], remaining[(i + 1) % n]});
+				remaining.erase(remaining.begin() + i);
+				i = i % (n - 1);
+				misses = 0;
+			}
+			else
+			{
+				i = (i + 1) % n;
+
+				// A whole lap without an ear, the polygon intersects itself.
+				if (++misses > n)
+				{
+					return false;
+				}
+			}
+		}
+
+		triangles.push_back(remaining);
+		return true;
+	}
+
+	uint64_t EdgeKey(int from, int to)
+	{
+		return (static_cast<uint64_t>(from) << 32) | static_cast<uint32_t>(to);
+	}
+
+	bool IsConvex(const std::vector<b2Vec2> &vertices, const std::vector<int> &polygon)
+	{
+		for (size_t i = 0, n = polygon.size(); i < n; i++)
+		{
+			if (Orient(vertices[polygon[i]], vertices[polygon[(i + 1) % n]], vertices[polygon[(i + 2) % n]]) < 0.0f)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Hertel-Mehlhorn, removes every diagonal between two pieces whose union is still convex and
+	// small enough for a b2PolygonShape.
+	void MergePieces(const std::vector<b2Vec2> &vertices, std::vector<std::vector<int>> &pieces)
+	{
+		// Which piece each directed edge belongs to.
+		std::unordered_map<uint64_t, size_t> owners;
+		std::vector<std::pair<int, int>> diagonals;
+		for (size_t p = 0; p < pieces.size(); p++)
+		{
+			for (size_t i = 0, n = pieces[p].size(); i < n; i++)
+			{
+				int from = pieces[p][i];
+				int to = pieces[p][(i + 1) % n];
+				owners[EdgeKey(from, to)] = p;
+			}
+		}
+
+		// Edges shared by two triangles, in the order of the triangles so the result is deterministic.
+		for (const std::vector<int> &piece : pieces)
+		{
+			for (size_t i = 0, n = piece.size(); i < n; i++)
+			{
+				int from = piece[i];
+				int to = piece[(i + 1) % n];
+				if (from < to && owners.count(EdgeKey(to, from)) > 0)
+				{
+					diagonals.push_back({from, to});
+				}
+			}
+		}
+
+		for (const auto &[u, w] : diagonals)
+		{
+			size_t a = owners[EdgeKey(u, w)];
+			size_t b = owners[EdgeKey(w, u)];
+			if (a == b)
+			{
+				continue;
+			}
+
+			const std::vector<int> &pieceA = pieces[a];
+			const std::vector<int> &pieceB = pieces[b];
+
+			if (pieceA.size() + pieceB.size() - 2 > b2_maxPolygonVertices)
+			{
+				continue;
+			}
+
+			size_t ia = std::find(pieceA.begin(), pieceA.end(), u) - pieceA.begin();
+			size_t ib = std::find(pieceB.begin(), pieceB.end(), w) - pieceB.begin();
+
+			// Around A from w back to u, then around B from after u to before w.
+			std::vector<int> merged;
+			for (size_t i = 1; i <= pieceA.size(); i++)
+			{
+				merged.push_back(pieceA[(ia + i) % pieceA.size()]);
+			}
+			for (size_t i = 2; i < pieceB.size(); i++)
+			{
+				merged.push_back(pieceB[(ib + i) % pieceB.size()]);
+			}
+
+			if (!IsConvex(vertices, merged))
+			{
+				continue;
+			}
+
+			owners.erase(EdgeKey(u, w));
+			owners.erase(EdgeKey(w, u));
+			for (size_t i = 0, n = merged.size(); i < n; i++)
+			{
+				owners[EdgeKey(merged[i], merged[(i + 1) % n])] = a;
+			}
+
+			pieces[a] = std::move(merged);
+			pieces[b].clear();
+		}
+
+		pieces.erase(std::remove_if(pieces.begin(), pieces.end(), [](const std::vector<int> &piece) { return piece.empty(); }), pieces.end());
+	}
+
+	// Welds the vertices of a piece exactly like b2PolygonShape::Set(), which asserts and falls back to
+	// a box when fewer than 3 are left, as with the tip of a thin spike.
+	std::vector<b2Vec2> Weld(const std::vector<b2Vec2> &vertices, const std::vector<int> &piece)
+	{
+		std::vector<b2Vec2> welded;
+		for (int index : piece)
+		{
+			const b2Vec2 &vertex = vertices[index];
+			bool unique = true;
+			for (const b2Vec2 &other : welded)
+			{
+				if (b2DistanceSquared(vertex, other) < (0.5f * b2_linearSlop) * (0.5f * b2_linearSlop))
+				{
+					unique = false;
+					break;
+				}
+			}
+
+			if (unique)
+			{
+				welded.push_back(vertex);
+			}
+		}
+		return welded;
+	}
+
+	ConvexDecomposition::Pieces Compute(const std::vector<Vector2> &points)
+	{
+		ConvexDecomposition::Pieces result;
+
+		std::vector<b2Vec2> vertices = Prepare(points);
+		if (vertices.size() < 3)
+		{
+			return result;
+		}
+
+		std::vector<std::vector<int>> pieces;
+		if (!Triangulate(vertices, pieces))
+		{
+			return result;
+		}
+		MergePieces(vertices, pieces);
+
+		for (const std::vector<int> &piece : pieces)
+		{
+			std::vector<b2Vec2> welded = Weld(vertices, piece);
+			if (welded.size() < 3)
+			{
+				continue;
+			}
+
+			float area = 0.0f;
+			for (size_t i = 0, n = welded.size(); i < n; i++)
+			{
+				area += b2Cross(welded[i], welded[(i + 1) % n]);
+			}
+
+			// Slivers left by nearly collinear points are too thin for Box2D's hull.
+			if (area <= b2_linearSlop * b2_linearSlop)
+			{
+				continue;
+			}
+
+			std::vector<Vector2> &out = result.emplace_back();
+			for (const b2Vec2 &vertex : welded)
+			{
+				out.push_back(Vector2(vertex.x, vertex.y));
+			}
+		}
+		return result;
+	}
+}
+
+std::shared_ptr<const ConvexDecomposition::Pieces> ConvexDecomposition::Decompose(const std::vector<Vector2> &points)
+{
+	DecompositionCache &cache = GetCache();
+	uint64_t hash = HashPoints(points);
+
+	{
+		std::lock_guard<std::mutex> lock(cache.mutex);
+		auto it = cache.entries.find(hash);
+		if (it != cache.entries.end() && SamePoints(it->second.points, points))
+		{
+			return it->second.pieces;
+		}
+	}
+
+	// Computed outside of the lock, so threads decomposing different outlines don't wait on each other.
+	std::shared_ptr<const Pieces> pieces = std::make_shared<const Pieces>(Compute(points));
+
+	std::lock_guard<std::mutex> lock(cache.mutex);
+	cache.entries[hash] = {points, pieces};
+	return pieces;
+}
+
+void ConvexDecomposition::ClearCache()
+{
+	DecompositionCache &cache = GetCache();
+	std::lock_guard<std::mutex> lock(cache.mutex);
+	cache.entries.clear();
+}
\ No newline at end of file
@@ -32,6 +32,7 @@ void DistanceJoint2D::Constructor()
 	{
 		rb = entity->AddComponent<Rigidbody2D>();
 	}
+	rb->attachments.push_back(this);
 
 	b2DistanceJointDef jointDef;
 	jointDef.bodyA = rb->body;
@@ -39,17 +40,13 @@ void DistanceJoint2D::Constructor()
 	joint = (b2DistanceJoint *)Physics::physicsWorld.CreateJoint(&jointDef);
 }
 
-void DistanceJoint2D::Tick()
-{
-	if (rb->isDestroyed)
-	{
-		Destroy();
-	}
-}
-
 void DistanceJoint2D::OnDestroy()
 {
 	Physics::physicsWorld.DestroyJoint(joint);
+	if (!rb->isDestroyed)
+	{
+		rb->Detach(this);
+	}
 }
 
 Vector2 DistanceJoint2D::GetAnchorA()
@@ -32,62 +32,21 @@ void EdgeCollider2D::Constructor()
     {
         rb = entity->AddComponent<Rigidbody2D>();
     }
+    rb->attachments.push_back(this);
 
-    b2ChainShape chainShape;
-    b2EdgeShape edgeShape;
-
-    int size = points.size();
-
-    if (size > 2)
-    {
-        if (size > 8)
-        {
-            Debug::LogError("The number of vertices in a edgeCollider must be <= 8, the number of vertices chosen is " + std::to_string(size));
-            return;
-        }
-
-        b2Vec2 vertices[size];
-        for (int i = 0, n = size; i < n; i++)
-        {
-            vertices[i].Set(points[i].x, points[i].y);
-        }
-        chainShape.CreateLoop(vertices, size);
-    }
-    else
-    {
-        if (size <= 0)
-        {
-            Debug::LogError("The number of vertices in a edgeCollider must be > 0, the number of vertices chosen is " + std::to_string(size));
-            return;
-        }
-
-        b2Vec2 vertices[size];
-        for (int i = 0, n = size; i < n; i++)
-        {
-            vertices[i].Set(points[i].x, points[i].y);
-        }
-
-        edgeShape.SetTwoSided(vertices[0], vertices[1]);
-    }
-
-    b2FixtureDef fixtureDef;
-    if (points.size() > 2)
-    {
-        fixtureDef.shape = &chainShape;
-    }
-    else
-    {
-        fixtureDef.shape = &edgeShape;
-    }
-
-    rb->body->CreateFixture(&fixtureDef);
+    // The fixture is created once the points are set.
 }
 
-void EdgeCollider2D::Tick()
+void EdgeCollider2D::OnDestroy()
 {
-    if (rb->isDestroyed)
+    // When the rigidbody itself is being destroyed, the fixture goes along with its body.
+    if (!rb->isDestroyed)
     {
-        Destroy();
+        if (fixture != nullptr)
+        {
+            rb->body->DestroyFixture(fixture);
+        }
+        rb->Detach(this);
     }
 }
 
@@ -113,61 +72,71 @@ bool EdgeCollider2D::GetIsTrigger()
 
 void EdgeCollider2D::SetPoints(std::vector<Vector2> val)
 {
-    points = val;
+    int size = val.size();
 
-    b2ChainShape chainShape;
-    b2EdgeShape edgeShape;
+    if (size < 2)
+    {
+        Debug::LogError("The number of vertices in a edgeCollider must be >= 2, the number of vertices chosen is " + std::to_string(size));
+        return;
+    }
 
-    int size = points.size();
+    points = val;
 
-    if (size > 2)
+    std::vector<b2Vec2> vertices(size);
+    for (int i = 0; i < size; i++)
     {
-        if (size > 8)
-        {
-            Debug::LogError("The number of vertices in a edgeCollider must be <= 8, the number of vertices chosen is " + std::to_string(size));
-            return;
-        }
-
-        b2Vec2 vertices[size];
-        for (int i = 0, n = size; i < n; i++)
-        {
-            vertices[i].Set(points[i].x, points[i].y);
-        }
-        chainShape.CreateLoop(vertices, size);
+        vertices[i].Set(points[i].x, points[i].y);
     }
-    else
-    {
-        if (size <= 0)
-        {
-            Debug::LogError("The number of vertices in a edgeCollider must be > 0, the number of vertices chosen is " + std::to_string(size));
-            return;
-        }
 
-        b2Vec2 vertices[size];
-        for (int i = 0, n = size; i < n; i++)
-        {
-            vertices[i].Set(points[i].x, points[i].y);
-        }
+    // The shape is edited in place as long as it keeps its type and number of children, so the
+    // fixture and its proxies are kept.
+    b2Shape *shape = fixture != nullptr ? fixture->GetShape() : nullptr;
+    if (shape != nullptr && shape->GetType() == b2Shape::e_edge && size == 2)
+    {
+        static_cast<b2EdgeShape *>(shape)->SetTwoSided(vertices[0], vertices[1]);
+        rb->MarkShapesDirty();
+        return;
+    }
 
-        edgeShape.SetTwoSided(vertices[0], vertices[1]);
+    if (shape != nullptr && shape->GetType() == b2Shape::e_chain && shape->GetChildCount() == size)
+    {
+        b2ChainShape *chainShape = static_cast<b2ChainShape *>(shape);
+        chainShape->Clear();
+        chainShape->CreateLoop(vertices.data(), size);
+        rb->MarkShapesDirty();
+        return;
     }
 
+    b2ChainShape chainShape;
+    b2EdgeShape edgeShape;
+
     b2FixtureDef fixtureDef;
-    if (points.size() > 2)
+    fixtureDef.filter = Physics::GetLayerFilter(layer);
+    if (size > 2)
     {
+        chainShape.CreateLoop(vertices.data(), size);
         fixtureDef.shape = &chainShape;
     }
     else
     {
+        edgeShape.SetTwoSided(vertices[0], vertices[1]);
         fixtureDef.shape = &edgeShape;
     }
 
-    rb->body->CreateFixture(&fixtureDef);
+    if (fixture != nullptr)
+    {
+        fixtureDef.density = GetDensity();
+        fixtureDef.friction = GetFriction();
+        fixtureDef.isSensor = GetIsTrigger();
+        rb->body->DestroyFixture(fixture);
+    }
+    fixture = rb->body->CreateFixture(&fixtureDef);
 }
 
 void EdgeCollider2D::SetDensity(float val)
 {
     fixture->SetDensity(val);
+    rb->MarkShapesDirty();
 }
 
 void EdgeCollider2D::SetFriction(float val)
@@ -178,4 +147,33 @@ void EdgeCollider2D::SetFriction(float val)
 void EdgeCollider2D::SetIsTrigger(bool val)
 {
     fixture->SetSensor(val);
+}
+
+int EdgeCollider2D::GetLayer()
+{
+    return layer;
+}
+
+void EdgeCollider2D::SetLayer(int val)
+{
+    if (val < 0 || val >= ProjectSettings::Physics::LAYER_COUNT)
+    {
+        Debug::LogError("The layer of a collider must be >= 0 and < " + std::to_string(ProjectSettings::Physics::LAYER_COUNT) + ", the layer chosen is " + std::to_string(val));
+        return;
+    }
+
+    layer = val;
+    if (fixture != nullptr)
+    {
+        fixture->SetFilterData(Physics::GetLayerFilter(layer));
+    }
+}
+
+void EdgeCollider2D::SetLayer(std::string_view layerName)
+{
+    int val = Physics::GetLayer(layerName);
+    if (val >= 0)
+    {
+        SetLayer(val);
+    }
 }
\ No newline at end of file
@@ -32,6 +32,7 @@ void FrictionJoint2D::Constructor()
 	{
 		rb = entity->AddComponent<Rigidbody2D>();
 	}
+	rb->attachments.push_back(this);
 
 	b2FrictionJointDef jointDef;
 	jointDef.bodyA = rb->body;
@@ -39,17 +40,13 @@ void FrictionJoint2D::Constructor()
 	joint = (b2FrictionJoint *)Physics::physicsWorld.CreateJoint(&jointDef);
 }
 
-void FrictionJoint2D::Tick()
-{
-	if (rb->isDestroyed)
-	{
-		Destroy();
-	}
-}
-
 void FrictionJoint2D::OnDestroy()
 {
 	Physics::physicsWorld.DestroyJoint(joint);
+	if (!rb->isDestroyed)
+	{
+		rb->Detach(this);
+	}
 }
 
 Vector2 FrictionJoint2D::GetAnchorA()
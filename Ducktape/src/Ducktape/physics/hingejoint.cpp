@@ -32,6 +32,7 @@ void HingeJoint2D::Constructor()
 	{
 		rb = entity->AddComponent<Rigidbody2D>();
 	}
+	rb->attachments.push_back(this);
 
 	b2RevoluteJointDef jointDef;
 	jointDef.bodyA = rb->body;
@@ -42,6 +43,10 @@ void HingeJoint2D::Constructor()
 void HingeJoint2D::OnDestroy()
 {
 	Physics::physicsWorld.DestroyJoint(joint);
+	if (!rb->isDestroyed)
+	{
+		rb->Detach(this);
+	}
 }
 
 Vector2 HingeJoint2D::GetAnchorA()
@@ -23,77 +23,654 @@ SOFTWARE.
 */
 
 #include <Ducktape/physics/physics.h>
+#include <Ducktape/physics/rigidbody.h>
+
+#include <algorithm>
+#include <bit>
+#include <cfenv>
+
 using namespace DT;
 
-void ContactListener::BeginContact(b2Contact *contact)
+namespace
 {
-	Entity *bodyA = reinterpret_cast<Entity *>(contact->GetFixtureA()->GetBody()->GetUserData().pointer);
-	Entity *bodyB = reinterpret_cast<Entity *>(contact->GetFixtureB()->GetBody()->GetUserData().pointer);
+	/**
+	 * @brief The rigidbodies awake before any step of the current frame, or after the last one.
+	 * Only their Transforms can be out of date, bodies asleep for the whole frame haven't moved.
+	 * Each one is in it once, flagged by Rigidbody2D::syncPending.
+	 */
+	std::vector<Rigidbody2D *> movingRigidbodies;
+
+	void QueueSync(Rigidbody2D *rb)
+	{
+		if (!rb->syncPending)
+		{
+			rb->syncPending = true;
+			movingRigidbodies.push_back(rb);
+		}
+	}
+
+	size_t GetDepth(Transform *transform)
+	{
+		size_t depth = 0;
+		for (Transform *parent = transform->GetParent(); parent != nullptr; parent = parent->GetParent())
+		{
+			depth++;
+		}
+		return depth;
+	}
+
+	/**
+	 * @brief Puts the default floating-point environment in place for its lifetime, when
+	 * ProjectSettings::Physics::deterministic is enabled, so a library changing the rounding
+	 * mode or flushing denormals on a thread can't change the results of physics running on it.
+	 */
+	class DeterministicFloats
+	{
+	public:
+		DeterministicFloats() : enabled(ProjectSettings::Physics::deterministic)
+		{
+			if (enabled)
+			{
+				std::fegetenv(&environment);
+				std::fesetenv(FE_DFL_ENV);
+			}
+		}
+
+		~DeterministicFloats()
+		{
+			if (enabled)
+			{
+				std::fesetenv(&environment);
+			}
+		}
+
+	private:
+		bool enabled;
+		std::fenv_t environment;
+	};
+
+	void StepWorld(float timeStep)
+	{
+		Physics::physicsWorld.Step(timeStep, Physics::velocityIterations, Physics::positionIterations);
+		Physics::stepCount++;
+		if (ProjectSettings::Physics::deterministic)
+		{
+			Physics::stepChecksum = Physics::ComputeChecksum();
+		}
+	}
+
+	// A fixedDeltaTime that isn't positive would never drain the accumulator.
+	float GetFixedDeltaTime()
+	{
+		if (!(ProjectSettings::Physics::fixedDeltaTime > 0.0f))
+		{
+			Debug::LogError("ProjectSettings::Physics::fixedDeltaTime must be greater than 0, using 1/60 instead.");
+			ProjectSettings::Physics::fixedDeltaTime = 1.0f / 60.0f;
+		}
+		return ProjectSettings::Physics::fixedDeltaTime;
+	}
 
-	for (BehaviourScript *bs : bodyA->components)
+	// A maxStepsPerFrame that isn't positive would cap the accumulator at 0 or below, so the world
+	// would never step and the interpolation factor could go negative.
+	int GetMaxStepsPerFrame()
 	{
-		if (bs != nullptr)
+		if (ProjectSettings::Physics::maxStepsPerFrame <= 0)
 		{
-			Collision collisionB;
-			collisionB.body = bodyB;
-			bs->OnCollisionEnter(collisionB);
+			Debug::LogError("ProjectSettings::Physics::maxStepsPerFrame must be greater than 0, using 1 instead.");
+			ProjectSettings::Physics::maxStepsPerFrame = 1;
 		}
+		return ProjectSettings::Physics::maxStepsPerFrame;
+	}
+
+	Entity *GetEntity(b2Fixture *fixture)
+	{
+		return reinterpret_cast<Entity *>(fixture->GetBody()->GetUserData().pointer);
+	}
+
+	void SendCollision(Entity *entity, const Collision &collision, bool enter)
+	{
+		// Indexed rather than ranged, a callback may add components to its entity.
+		for (size_t i = 0; i < entity->components.size() && !entity->isDestroyed; i++)
+		{
+			BehaviourScript *bs = entity->components[i];
+
+			if (bs == nullptr || !bs->receivesCollisions || bs->isDestroyed)
+			{
+				continue;
+			}
+
+			if (enter)
+			{
+				bs->OnCollisionEnter(collision);
+			}
+			else
+			{
+				bs->OnCollisionExit(collision);
+			}
+		}
+	}
+}
+
+uint64_t ContactListener::PairKey(EntityHandle a, EntityHandle b)
+{
+	uint64_t low = std::min(a.index, b.index);
+	uint64_t high = std::max(a.index, b.index);
+	return (low << 32) | high;
+}
+
+void ContactListener::BeginContact(b2Contact *contact)
+{
+	Entity *entityA = GetEntity(contact->GetFixtureA());
+	Entity *entityB = GetEntity(contact->GetFixtureB());
+	uint64_t key = PairKey(entityA->handle, entityB->handle);
+
+	if (touching[key]++ > 0)
+	{
+		return;
 	}
 
-	for (BehaviourScript *bs : bodyB->components)
+	Event event;
+	event.entityA = entityA->handle;
+	event.entityB = entityB->handle;
+	event.enter = true;
+	event.contact = contact;
+	event.normal = Vector2(0.0f, 0.0f);
+	event.pointCount = contact->GetManifold()->pointCount;
+	event.normalImpulses[0] = event.normalImpulses[1] = 0.0f;
+
+	if (event.pointCount > 0)
 	{
-		if (bs != nullptr)
+		b2WorldManifold worldManifold;
+		contact->GetWorldManifold(&worldManifold);
+
+		event.normal = Vector2(worldManifold.normal.x, worldManifold.normal.y);
+		for (int i = 0; i < event.pointCount; i++)
 		{
-			Collision collisionA;
-			collisionA.body = bodyA;
-			bs->OnCollisionEnter(collisionA);
+			event.points[i] = Vector2(worldManifold.points[i].x, worldManifold.points[i].y);
 		}
 	}
+
+	pendingEnter[key] = events.size();
+	events.push_back(event);
 }
 
 void ContactListener::EndContact(b2Contact *contact)
 {
+	Entity *entityA = GetEntity(contact->GetFixtureA());
+	Entity *entityB = GetEntity(contact->GetFixtureB());
+	uint64_t key = PairKey(entityA->handle, entityB->handle);
+
+	auto it = touching.find(key);
+	if (it == touching.end() || --it->second > 0)
+	{
+		return;
+	}
+
+	touching.erase(it);
+	pendingEnter.erase(key);
+
+	Event event;
+	event.entityA = entityA->handle;
+	event.entityB = entityB->handle;
+	event.enter = false;
+	event.contact = nullptr;
+	event.normal = Vector2(0.0f, 0.0f);
+	event.pointCount = 0;
+	event.normalImpulses[0] = event.normalImpulses[1] = 0.0f;
+	events.push_back(event);
+}
+
+void ContactListener::PostSolve(b2Contact *contact, const b2ContactImpulse *impulse)
+{
+	// Called for every touching contact on every step, so bail out before hashing anything
+	// in the common case of no collision having started.
+	if (pendingEnter.empty())
+	{
+		return;
+	}
+
+	Entity *entityA = GetEntity(contact->GetFixtureA());
+	Entity *entityB = GetEntity(contact->GetFixtureB());
+
+	auto it = pendingEnter.find(PairKey(entityA->handle, entityB->handle));
+	if (it == pendingEnter.end() || events[it->second].contact != contact)
+	{
+		return;
+	}
+
+	Event &event = events[it->second];
+	for (int32 i = 0; i < impulse->count && i < 2; i++)
+	{
+		event.normalImpulses[i] = impulse->normalImpulses[i];
+	}
+
+	pendingEnter.erase(it);
+}
+
+void ContactListener::Dispatch()
+{
+	if (events.empty())
+	{
+		return;
+	}
 
-	Entity *bodyA = reinterpret_cast<Entity *>(contact->GetFixtureA()->GetBody()->GetUserData().pointer);
-	Entity *bodyB = reinterpret_cast<Entity *>(contact->GetFixtureB()->GetBody()->GetUserData().pointer);
+	// Callbacks that destroy bodies cause new events, those wait for the next dispatch.
+	dispatching.swap(events);
+	pendingEnter.clear();
 
-	for (BehaviourScript *bs : bodyA->components)
+	for (const Event &event : dispatching)
 	{
-		if (bs != nullptr)
+		Entity *entityA = Entity::Get(event.entityA);
+		Entity *entityB = Entity::Get(event.entityB);
+
+		Collision collision;
+		collision.pointCount = event.pointCount;
+		for (int i = 0; i < event.pointCount; i++)
+		{
+			collision.points[i] = event.points[i];
+			collision.normalImpulses[i] = event.normalImpulses[i];
+		}
+		collision.point = collision.points[0];
+
+		if (entityA != nullptr)
 		{
-			Collision collisionB;
-			collisionB.body = bodyB;
-			bs->OnCollisionExit(collisionB);
+			collision.body = entityB;
+			collision.normal = event.normal;
+			SendCollision(entityA, collision, event.enter);
+		}
+
+		if (entityB != nullptr)
+		{
+			// Looked up again, entityA may have been destroyed by its own callbacks.
+			collision.body = Entity::Get(event.entityA);
+			collision.normal = Vector2(-event.normal.x, -event.normal.y);
+			SendCollision(entityB, collision, event.enter);
 		}
 	}
 
-	for (BehaviourScript *bs : bodyB->components)
+	dispatching.clear();
+}
+
+void ContactListener::Reset(b2Contact *contactList)
+{
+	touching.clear();
+	pendingEnter.clear();
+	events.clear();
+
+	for (b2Contact *contact = contactList; contact != nullptr; contact = contact->GetNext())
 	{
-		if (bs != nullptr)
+		if (contact->IsTouching())
 		{
-			Collision collisionA;
-			collisionA.body = bodyA;
-			bs->OnCollisionExit(collisionA);
+			touching[PairKey(GetEntity(contact->GetFixtureA())->handle, GetEntity(contact->GetFixtureB())->handle)]++;
 		}
 	}
 }
 
-b2Vec2 Physics::b2Gravity(0.0, 0.0);
 b2World Physics::physicsWorld(b2Vec2(0.0, 0.0));
 int32 Physics::velocityIterations = 6;
 int32 Physics::positionIterations = 2;
-Vector2 Physics::globalGravity = Vector2(0.0f, 1.0f);
+float Physics::accumulator = 0.0f;
 ContactListener Physics::contactListener;
+JobSystemTaskExecutor Physics::taskExecutor;
+uint64_t Physics::stepCount = 0;
+uint64_t Physics::stepChecksum = 0;
+std::vector<Rigidbody2D *> Physics::dirtyRigidbodies;
+int Physics::batchDepth = 0;
+std::vector<Rigidbody2D *> Physics::batchedRigidbodies;
+std::vector<Rigidbody2D *> Physics::movableRigidbodies;
+
+int32 JobSystemTaskExecutor::GetThreadCount() const
+{
+	return JobSystem::GetWorkerCount() + 1;
+}
+
+void JobSystemTaskExecutor::ParallelFor(b2Task *task, int32 count, int32 minRange)
+{
+	JobSystem::ParallelFor(count, minRange, [task](size_t begin, size_t end)
+	{
+		DeterministicFloats floats;
+		task->Execute(begin, end, JobSystem::GetThreadIndex());
+	});
+}
 
 void Physics::Init()
 {
-	globalGravity = ProjectSettings::Physics::globalGravity;
+	SetGravity(ProjectSettings::Physics::globalGravity);
 	physicsWorld.SetContactListener(&contactListener);
+	physicsWorld.SetTaskExecutor(ProjectSettings::Physics::parallelIslands ? &taskExecutor : nullptr);
+	GetFixedDeltaTime();
+	GetMaxStepsPerFrame();
+
+#ifndef DT_STRICT_FLOAT
+	if (ProjectSettings::Physics::deterministic)
+	{
+		Debug::LogWarning("Deterministic physics is enabled, but Ducktape wasn't built with DUCKTAPE_STRICT_FLOAT, results may differ between builds.");
+	}
+#endif
+}
+
+void Physics::SetGravity(Vector2 gravity)
+{
+	physicsWorld.SetGravity((b2Vec2)gravity);
+
+	// Sleeping bodies don't integrate gravity, so they would ignore the change until something
+	// touched them.
+	for (b2Body *body = physicsWorld.GetBodyList(); body != nullptr; body = body->GetNext())
+	{
+		if (body->GetType() != b2_staticBody)
+		{
+			body->SetAwake(true);
+		}
+	}
+}
+
+Vector2 Physics::GetGravity()
+{
+	b2Vec2 gravity = physicsWorld.GetGravity();
+	return Vector2(gravity.x, gravity.y);
+}
+
+int Physics::GetLayer(std::string_view name)
+{
+	for (int i = 0; i < ProjectSettings::Physics::LAYER_COUNT; i++)
+	{
+		if (ProjectSettings::Physics::layerNames[i] == name)
+		{
+			return i;
+		}
+	}
+
+	Debug::LogError("Collision layer with name \"" + std::string(name) + "\" doesn't exist!");
+	return -1;
+}
+
+uint16_t Physics::GetLayerMask(std::initializer_list<std::string_view> names)
+{
+	uint16_t mask = 0;
+	for (std::string_view name : names)
+	{
+		int layer = GetLayer(name);
+		if (layer >= 0)
+		{
+			mask |= 1 << layer;
+		}
+	}
+	return mask;
+}
+
+b2Filter Physics::GetLayerFilter(int layer)
+{
+	b2Filter filter;
+	filter.categoryBits = 1 << layer;
+	filter.maskBits = ProjectSettings::Physics::layerCollisionMatrix[layer];
+	return filter;
+}
+
+void Physics::SetLayerCollision(int layerA, int layerB, bool collide)
+{
+	std::array<uint16_t, ProjectSettings::Physics::LAYER_COUNT> &matrix = ProjectSettings::Physics::layerCollisionMatrix;
+
+	if (collide)
+	{
+		matrix[layerA] |= 1 << layerB;
+		matrix[layerB] |= 1 << layerA;
+	}
+	else
+	{
+		matrix[layerA] &= ~(1 << layerB);
+		matrix[layerB] &= ~(1 << layerA);
+	}
+
+	RefreshLayerFilters();
+}
+
+void Physics::RefreshLayerFilters()
+{
+	for (b2Body *body = physicsWorld.GetBodyList(); body != nullptr; body = body->GetNext())
+	{
+		for (b2Fixture *fixture = body->GetFixtureList(); fixture != nullptr; fixture = fixture->GetNext())
+		{
+			// The category of a collider is the bit of its layer.
+			int layer = std::countr_zero(fixture->GetFilterData().categoryBits);
+			if (layer >= ProjectSettings::Physics::LAYER_COUNT)
+			{
+				continue;
+			}
+
+			b2Filter filter = GetLayerFilter(layer);
+			if (filter.maskBits != fixture->GetFilterData().maskBits)
+			{
+				// Flags the contacts of the fixture for filtering again on the next step.
+				fixture->SetFilterData(filter);
+			}
+		}
+	}
+}
+
+void Physics::BeginBatch()
+{
+	batchDepth++;
+}
+
+void Physics::EndBatch()
+{
+	if (batchDepth == 0 || --batchDepth > 0)
+	{
+		return;
+	}
+
+	std::vector<b2Body *> bodies;
+	bodies.reserve(batchedRigidbodies.size());
+	for (Rigidbody2D *rb : batchedRigidbodies)
+	{
+		bodies.push_back(rb->body);
+	}
+	batchedRigidbodies.clear();
+
+	// The proxies of the whole batch are built into one subtree, inserted in the tree at once.
+	physicsWorld.EnableBodies(bodies.data(), bodies.size());
+}
+
+bool Physics::IsBatching()
+{
+	return batchDepth > 0;
+}
+
+void Physics::RebuildBroadphase()
+{
+	physicsWorld.RebuildTree();
+}
+
+BroadphaseStats Physics::GetBroadphaseStats()
+{
+	BroadphaseStats stats;
+	stats.proxyCount = physicsWorld.GetProxyCount();
+	stats.height = physicsWorld.GetTreeHeight();
+	stats.maxBalance = physicsWorld.GetTreeBalance();
+	stats.areaRatio = physicsWorld.GetTreeQuality();
+	return stats;
+}
+
+void Physics::SynchronizeShapes()
+{
+	for (Rigidbody2D *rb : dirtyRigidbodies)
+	{
+		rb->body->SynchronizeShapes();
+
+		// A shape may have grown into something while the body was asleep.
+		if (rb->body->GetType() != b2_staticBody)
+		{
+			rb->body->SetAwake(true);
+		}
+		rb->shapesDirty = false;
+	}
+	dirtyRigidbodies.clear();
+}
+
+void Physics::Step(float deltaTime)
+{
+	DeterministicFloats floats;
+	SynchronizeShapes();
+
+	if (!ProjectSettings::Physics::fixedTimestep && !ProjectSettings::Physics::deterministic)
+	{
+		StorePreviousState();
+		StepWorld(deltaTime);
+		SyncTransforms();
+		contactListener.Dispatch();
+		Time::interpolationAlpha = 1.0f;
+		return;
+	}
+
+	float fixedDeltaTime = GetFixedDeltaTime();
+
+	// Drop whatever time can't be caught up on this frame, instead of carrying it
+	// over and making the next frame even longer.
+	accumulator = std::min(accumulator + deltaTime, fixedDeltaTime * GetMaxStepsPerFrame());
+
+	bool stepped = false;
+	while (accumulator >= fixedDeltaTime)
+	{
+		StorePreviousState();
+		StepWorld(fixedDeltaTime);
+		accumulator -= fixedDeltaTime;
+		stepped = true;
+	}
+
+	if (stepped)
+	{
+		SyncTransforms();
+		contactListener.Dispatch();
+	}
+
+	Time::interpolationAlpha = accumulator / fixedDeltaTime;
+}
+
+void Physics::StorePreviousState()
+{
+	for (Rigidbody2D *rb : movableRigidbodies)
+	{
+		b2Body *body = rb->body;
+		if (!body->IsAwake())
+		{
+			continue;
+		}
+
+		rb->entity->transform->StorePreviousState(Vector2(body->GetPosition().x, body->GetPosition().y), body->GetAngle());
+		QueueSync(rb);
+	}
+}
+
+void Physics::SyncTransforms()
+{
+	// Bodies woken during the last step moved in it too.
+	for (Rigidbody2D *rb : movableRigidbodies)
+	{
+		if (rb->body->IsAwake())
+		{
+			QueueSync(rb);
+		}
+	}
+
+	bool nested = false;
+	for (Rigidbody2D *rb : movingRigidbodies)
+	{
+		nested = nested || rb->entity->transform->GetParent() != nullptr;
+	}
+
+	// A child's local pose is worked out from its parent's world pose, so the parent has to be
+	// synced first. Only needed when some moving body has a parent, which is rare.
+	if (nested)
+	{
+		std::stable_sort(movingRigidbodies.begin(), movingRigidbodies.end(), [](Rigidbody2D *a, Rigidbody2D *b)
+		{
+			return GetDepth(a->entity->transform) < GetDepth(b->entity->transform);
+		});
+	}
+
+	for (Rigidbody2D *rb : movingRigidbodies)
+	{
+		b2Body *body = rb->body;
+		Transform *transform = rb->entity->transform;
+		Vector2 position = Vector2(body->GetPosition().x, body->GetPosition().y);
+		transform->SetPoseFromPhysics(position, body->GetAngle());
+
+		// A body put to sleep during the frame rests where it is, without interpolating from the
+		// pose of an earlier step. Its previous state stays valid until it's woken again.
+		if (!body->IsAwake())
+		{
+			transform->StorePreviousState(position, body->GetAngle());
+		}
+		rb->syncPending = false;
+	}
+	movingRigidbodies.clear();
+}
+
+uint64_t Physics::ComputeChecksum()
+{
+	// FNV-1a over the bits of each value, a word at a time rather than a byte.
+	uint64_t checksum = 14695981039346656037ull;
+	auto add = [&checksum](uint32_t value)
+	{
+		checksum = (checksum ^ value) * 1099511628211ull;
+	};
+
+	for (b2Body *body = physicsWorld.GetBodyList(); body != nullptr; body = body->GetNext())
+	{
+		add(std::bit_cast<uint32_t>(body->GetPosition().x));
+		add(std::bit_cast<uint32_t>(body->GetPosition().y));
+		add(std::bit_cast<uint32_t>(body->GetAngle()));
+		add(std::bit_cast<uint32_t>(body->GetLinearVelocity().x));
+		add(std::bit_cast<uint32_t>(body->GetLinearVelocity().y));
+		add(std::bit_cast<uint32_t>(body->GetAngularVelocity()));
+		add(body->IsAwake());
+	}
+	return checksum;
+}
+
+void Physics::SaveState(b2WorldState &state)
+{
+	// Pending shape edits would otherwise be applied after a restore, on top of the saved state.
+	SynchronizeShapes();
+	physicsWorld.SaveState(&state);
+}
+
+bool Physics::RestoreState(const b2WorldState &state)
+{
+	if (!physicsWorld.RestoreState(&state))
+	{
+		Debug::LogError("The physics state was saved from a different set of bodies, colliders and joints!");
+		return false;
+	}
+
+	contactListener.Reset(physicsWorld.GetContactList());
+
+	for (b2Body *body = physicsWorld.GetBodyList(); body != nullptr; body = body->GetNext())
+	{
+		Entity *entity = reinterpret_cast<Entity *>(body->GetUserData().pointer);
+		Vector2 position = Vector2(body->GetPosition().x, body->GetPosition().y);
+		entity->transform->StorePreviousState(position, body->GetAngle());
+		entity->transform->SetPoseFromPhysics(position, body->GetAngle());
+	}
+	return true;
 }
 
 Collision Physics::Raycast(Vector2 origin, Vector2 direction)
 {
-	Collision raycastCallback;
-	physicsWorld.RayCast(&raycastCallback, (b2Vec2)origin, (b2Vec2)direction);
-	return raycastCallback;
+	Ray ray;
+	ray.origin = origin;
+	ray.direction = direction;
+
+	RaycastHit hit;
+	uint32_t hitCount = 0;
+	RaycastBatch(std::span<const Ray>(&ray, 1), std::span<RaycastHit>(&hit, 1), std::span<uint32_t>(&hitCount, 1));
+
+	Collision collision;
+	if (hitCount > 0)
+	{
+		collision.body = Entity::Get(hit.entity);
+		collision.point = hit.point;
+		collision.normal = hit.normal;
+	}
+	return collision;
 }
\ No newline at end of file
@@ -32,36 +32,28 @@ void PolygonCollider2D::Constructor()
     {
         rb = entity->AddComponent<Rigidbody2D>();
     }
+    rb->attachments.push_back(this);
 
-    b2PolygonShape collisionShape;
-
-    int size = points.size();
-
-    if (size < 3 || size > 8)
-    {
-        Debug::LogError("The number of vertices in a polygonCollider must be >= 3 and <= 8, the number of vertices chosen is " + std::to_string(size));
-        return;
-    }
+    // The fixtures are created once the points are set.
+}
 
-    b2Vec2 vertices[size];
-    for (int i = 0, n = size; i < n; i++)
+void PolygonCollider2D::OnDestroy()
+{
+    // When the rigidbody itself is being destroyed, the fixtures go along with its body.
+    if (!rb->isDestroyed)
     {
-        vertices[i].Set(points[i].x, points[i].y);
+        DestroyFixtures();
+        rb->Detach(this);
     }
-    collisionShape.Set(vertices, size);
-
-    b2FixtureDef fixtureDef;
-    fixtureDef.shape = &collisionShape;
-
-    rb->body->CreateFixture(&fixtureDef);
 }
 
-void PolygonCollider2D::Tick()
+void PolygonCollider2D::DestroyFixtures()
 {
-    if (rb->isDestroyed)
+    for (b2Fixture *fixture : fixtures)
     {
-        Destroy();
+        rb->body->DestroyFixture(fixture);
     }
+    fixtures.clear();
 }
 
 std::vector<Vector2> PolygonCollider2D::GetPoints()
@@ -71,84 +63,130 @@ std::vector<Vector2> PolygonCollider2D::GetPoints()
 
 float PolygonCollider2D::GetDensity()
 {
-    return fixture->GetDensity();
+    return density;
 }
 
 float PolygonCollider2D::GetFriction()
 {
-    return fixture->GetFriction();
+    return friction;
 }
 
 bool PolygonCollider2D::GetIsTrigger()
 {
-    return fixture->IsSensor();
+    return isTrigger;
 }
 
 void PolygonCollider2D::SetPoints(std::vector<Vector2> val)
 {
-    points = val;
+    int size = val.size();
 
-    b2ChainShape chainShape;
-    b2EdgeShape edgeShape;
+    if (size < 3)
+    {
+        Debug::LogError("The number of vertices in a polygonCollider must be >= 3, the number of vertices chosen is " + std::to_string(size));
+        return;
+    }
 
-    int size = points.size();
+    std::shared_ptr<const ConvexDecomposition::Pieces> pieces = ConvexDecomposition::Decompose(val);
+    if (pieces->empty())
+    {
+        Debug::LogError("The polygonCollider could not be decomposed into convex pieces, its edges must not cross each other.");
+        return;
+    }
 
-    if (size > 2)
+    points = val;
+
+    std::vector<b2PolygonShape> shapes(pieces->size());
+    for (size_t i = 0; i < pieces->size(); i++)
     {
-        if (size > 8)
-        {
-            Debug::LogError("The number of vertices in a edgeCollider must be <= 8, the number of vertices chosen is " + std::to_string(size));
-            return;
-        }
+        const std::vector<Vector2> &piece = (*pieces)[i];
 
-        b2Vec2 vertices[size];
-        for (int i = 0, n = size; i < n; i++)
+        b2Vec2 vertices[b2_maxPolygonVertices];
+        for (size_t j = 0; j < piece.size(); j++)
         {
-            vertices[i].Set(points[i].x, points[i].y);
+            vertices[j].Set(piece[j].x, piece[j].y);
         }
-        chainShape.CreateLoop(vertices, size);
+        shapes[i].Set(vertices, piece.size());
     }
-    else
+
+    // With as many pieces as before, the shapes are edited in place and the fixtures are kept.
+    if (fixtures.size() == shapes.size())
     {
-        if (size <= 0)
+        for (size_t i = 0; i < shapes.size(); i++)
         {
-            Debug::LogError("The number of vertices in a edgeCollider must be > 0, the number of vertices chosen is " + std::to_string(size));
-            return;
+            *static_cast<b2PolygonShape *>(fixtures[i]->GetShape()) = shapes[i];
         }
+        rb->MarkShapesDirty();
+        return;
+    }
 
-        b2Vec2 vertices[size];
-        for (int i = 0, n = size; i < n; i++)
-        {
-            vertices[i].Set(points[i].x, points[i].y);
-        }
+    DestroyFixtures();
 
-        edgeShape.SetTwoSided(vertices[0], vertices[1]);
+    b2FixtureDef fixtureDef;
+    fixtureDef.filter = Physics::GetLayerFilter(layer);
+    fixtureDef.density = density;
+    fixtureDef.friction = friction;
+    fixtureDef.isSensor = isTrigger;
+
+    for (b2PolygonShape &shape : shapes)
+    {
+        fixtureDef.shape = &shape;
+        fixtures.push_back(rb->body->CreateFixture(&fixtureDef));
     }
+}
 
-    b2FixtureDef fixtureDef;
-    if (points.size() > 2)
+void PolygonCollider2D::SetDensity(float val)
+{
+    density = val;
+    for (b2Fixture *fixture : fixtures)
     {
-        fixtureDef.shape = &chainShape;
+        fixture->SetDensity(val);
     }
-    else
+    rb->MarkShapesDirty();
+}
+
+void PolygonCollider2D::SetFriction(float val)
+{
+    friction = val;
+    for (b2Fixture *fixture : fixtures)
     {
-        fixtureDef.shape = &edgeShape;
+        fixture->SetFriction(val);
     }
+}
 
-    rb->body->CreateFixture(&fixtureDef);
+void PolygonCollider2D::SetIsTrigger(bool val)
+{
+    isTrigger = val;
+    for (b2Fixture *fixture : fixtures)
+    {
+        fixture->SetSensor(val);
+    }
 }
 
-void PolygonCollider2D::SetDensity(float val)
+int PolygonCollider2D::GetLayer()
 {
-    fixture->SetDensity(val);
+    return layer;
 }
 
-void PolygonCollider2D::SetFriction(float val)
+void PolygonCollider2D::SetLayer(int val)
 {
-    fixture->SetFriction(val);
+    if (val < 0 || val >= ProjectSettings::Physics::LAYER_COUNT)
+    {
+        Debug::LogError("The layer of a collider must be >= 0 and < " + std::to_string(ProjectSettings::Physics::LAYER_COUNT) + ", the layer chosen is " + std::to_string(val));
+        return;
+    }
+
+    layer = val;
+    for (b2Fixture *fixture : fixtures)
+    {
+        fixture->SetFilterData(Physics::GetLayerFilter(layer));
+    }
 }
 
-void PolygonCollider2D::SetIsTrigger(bool val)
+void PolygonCollider2D::SetLayer(std::string_view layerName)
 {
-    fixture->SetSensor(val);
+    int val = Physics::GetLayer(layerName);
+    if (val >= 0)
+    {
+        SetLayer(val);
+    }
 }
\ No newline at end of file
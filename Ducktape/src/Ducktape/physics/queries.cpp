@@ -0,0 +1,458 @@
+/*
+MIT License
+
+Copyright (c) 2022 Ducktape
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <Ducktape/physics/queries.h>
+#include <Ducktape/physics/physics.h>
+
+#include <box2d/b2_distance.h>
+
+#include <algorithm>
+
+using namespace DT;
+
+namespace
+{
+	// The number of casts handed to a worker at once, a single cast is too little work to be worth a job.
+	constexpr size_t QUERY_CHUNK_SIZE = 32;
+
+	// Keeps the hits of a single cast in the slots it was given, sorted by fraction.
+	class HitCollector
+	{
+	public:
+		HitCollector(RaycastHit *hits, uint32_t capacity, QueryMode mode, uint16_t layerMask)
+			: hits(hits), capacity(capacity), mode(mode), layerMask(layerMask)
+		{
+		}
+
+		bool Accepts(const b2Fixture *fixture) const
+		{
+			return !fixture->IsSensor() && (fixture->GetFilterData().categoryBits & layerMask) != 0;
+		}
+
+		// If a new hit has to be closer than the furthest one kept to be of any use.
+		bool IsFull() const
+		{
+			return mode == QueryMode::All ? count == capacity : count > 0;
+		}
+
+		// The fraction beyond which hits don't matter anymore.
+		float GetMaxFraction() const
+		{
+			return IsFull() ? hits[count - 1].fraction : 1.0f;
+		}
+
+		bool IsDone() const
+		{
+			return mode == QueryMode::Any && count > 0;
+		}
+
+		void Add(b2Fixture *fixture, const b2Vec2 &point, const b2Vec2 &normal, float fraction)
+		{
+			if (IsFull() && fraction >= hits[count - 1].fraction)
+			{
+				return;
+			}
+
+			RaycastHit hit;
+			hit.entity = reinterpret_cast<Entity *>(fixture->GetBody()->GetUserData().pointer)->handle;
+			hit.point = Vector2(point.x, point.y);
+			hit.normal = Vector2(normal.x, normal.y);
+			hit.fraction = fraction;
+
+			if (mode != QueryMode::All)
+			{
+				hits[0] = hit;
+				count = 1;
+				return;
+			}
+
+			// Insertion into the sorted slots, the furthest hit falls off when they're full.
+			uint32_t i = count < capacity ? count++ : count - 1;
+			while (i > 0 && hits[i - 1].fraction > fraction)
+			{
+				hits[i] = hits[i - 1];
+				i--;
+			}
+			hits[i] = hit;
+		}
+
+		uint32_t count = 0;
+
+	private:
+		RaycastHit *hits;
+		uint32_t capacity;
+		QueryMode mode;
+		uint16_t layerMask;
+	};
+
+	class RaycastCallback : public b2RayCastCallback
+	{
+	public:
+		explicit RaycastCallback(HitCollector &collector) : collector(collector) {}
+
+		float ReportFixture(b2Fixture *fixture, const b2Vec2 &point, const b2Vec2 &normal, float fraction) override
+		{
+			if (!collector.Accepts(fixture))
+			{
+				return -1.0f;
+			}
+
+			collector.Add(fixture, point, normal, fraction);
+			return collector.IsDone() ? 0.0f : collector.GetMaxFraction();
+		}
+
+	private:
+		HitCollector &collector;
+	};
+
+	class ShapeCastCallback
+	{
+	public:
+		ShapeCastCallback(HitCollector &collector, const ShapeCast &cast, const b2BroadPhase &broadPhase)
+			: collector(collector), cast(cast), broadPhase(broadPhase)
+		{
+			castTransform.Set((b2Vec2)cast.origin, cast.angle);
+		}
+
+		// Called by the broadphase for every proxy overlapping the swept bounds of the cast.
+		bool QueryCallback(int32 proxyId)
+		{
+			const b2FixtureProxy *proxy = static_cast<const b2FixtureProxy *>(broadPhase.GetUserData(proxyId));
+			b2Fixture *fixture = proxy->fixture;
+
+			if (!collector.Accepts(fixture))
+			{
+				return true;
+			}
+
+			b2ShapeCastInput input;
+			input.proxyA.Set(fixture->GetShape(), proxy->childIndex);
+			input.transformA = fixture->GetBody()->GetTransform();
+			input.transformB = castTransform;
+			input.translationB = (b2Vec2)cast.direction;
+
+			for (int32 child = 0; child < cast.shape->GetChildCount(); child++)
+			{
+				input.proxyB.Set(cast.shape, child);
+
+				b2ShapeCastOutput output;
+				if (b2ShapeCast(&output, &input))
+				{
+					collector.Add(fixture, output.point, output.normal, output.lambda);
+				}
+			}
+
+			return !collector.IsDone();
+		}
+
+		b2Transform castTransform;
+
+	private:
+		HitCollector &collector;
+		const ShapeCast &cast;
+		const b2BroadPhase &broadPhase;
+	};
+
+	class OverlapCallback
+	{
+	public:
+		OverlapCallback(const b2Shape &shape, const b2Transform &transform, uint16_t layerMask, std::span<EntityHandle> results, bool countOnly)
+			: shape(shape), transform(transform), layerMask(layerMask), results(results), countOnly(countOnly),
+			  broadPhase(Physics::physicsWorld.GetContactManager().m_broadPhase)
+		{
+			shape.ComputeAABB(&bounds, transform, 0);
+		}
+
+		size_t Run()
+		{
+			broadPhase.Query(this, bounds);
+			return count;
+		}
+
+		// Called by the broadphase for every proxy overlapping the bounds of the shape.
+		bool QueryCallback(int32 proxyId)
+		{
+			const b2FixtureProxy *proxy = static_cast<const b2FixtureProxy *>(broadPhase.GetUserData(proxyId));
+			b2Fixture *fixture = proxy->fixture;
+			b2Body *body = fixture->GetBody();
+
+			if (!Overlaps(fixture, proxy->childIndex) || ReportedBefore(body, fixture, proxy->childIndex))
+			{
+				return true;
+			}
+
+			if (!countOnly)
+			{
+				results[count] = reinterpret_cast<Entity *>(body->GetUserData().pointer)->handle;
+			}
+			lastBody = body;
+			count++;
+
+			return countOnly || count < results.size();
+		}
+
+	private:
+		bool Overlaps(b2Fixture *fixture, int32 childIndex) const
+		{
+			if (fixture->IsSensor() || (fixture->GetFilterData().categoryBits & layerMask) == 0)
+			{
+				return false;
+			}
+
+			return b2TestOverlap(bounds, fixture->GetAABB(childIndex)) &&
+				   b2TestOverlap(&shape, 0, fixture->GetShape(), childIndex, transform, fixture->GetBody()->GetTransform());
+		}
+
+		// An entity with several fixture children can overlap through more than one of them.
+		bool ReportedBefore(b2Body *body, b2Fixture *fixture, int32 childIndex) const
+		{
+			b2Fixture *first = body->GetFixtureList();
+			if (first->GetNext() == nullptr && first->GetShape()->GetChildCount() == 1)
+			{
+				return false;
+			}
+
+			// The children of a body are usually found one after another.
+			if (body == lastBody)
+			{
+				return true;
+			}
+
+			if (!countOnly)
+			{
+				EntityHandle handle = reinterpret_cast<Entity *>(body->GetUserData().pointer)->handle;
+				return std::find(results.begin(), results.begin() + count, handle) != results.begin() + count;
+			}
+
+			// Nothing was written to look through, so count the entity from the first of its
+			// children in fixture order that overlaps.
+			return OverlapsBefore(fixture, childIndex);
+		}
+
+		bool OverlapsBefore(b2Fixture *fixture, int32 childIndex) const
+		{
+			for (b2Fixture *other = fixture->GetBody()->GetFixtureList(); other != nullptr; other = other->GetNext())
+			{
+				int32 childCount = other == fixture ? childIndex : other->GetShape()->GetChildCount();
+				for (int32 child = 0; child < childCount; child++)
+				{
+					if (Overlaps(other, child))
+					{
+						return true;
+					}
+				}
+
+				if (other == fixture)
+				{
+					break;
+				}
+			}
+			return false;
+		}
+
+		const b2Shape &shape;
+		b2Transform transform;
+		uint16_t layerMask;
+		std::span<EntityHandle> results;
+		bool countOnly;
+		const b2BroadPhase &broadPhase;
+		b2AABB bounds;
+		b2Body *lastBody = nullptr;
+		size_t count = 0;
+	};
+
+	size_t Overlap(const b2Shape &shape, const b2Transform &transform, std::span<EntityHandle> results, bool countOnly, uint16_t layerMask)
+	{
+		if (!countOnly && results.empty())
+		{
+			return 0;
+		}
+
+		OverlapCallback callback(shape, transform, layerMask, results, countOnly);
+		return callback.Run();
+	}
+
+	size_t QueryBox(Vector2 center, Vector2 size, float angle, std::span<EntityHandle> results, bool countOnly, uint16_t layerMask)
+	{
+		b2PolygonShape box;
+		box.SetAsBox(size.x / 2.0f, size.y / 2.0f);
+		return Overlap(box, b2Transform((b2Vec2)center, b2Rot(angle)), results, countOnly, layerMask);
+	}
+
+	size_t QueryCircle(Vector2 center, float radius, std::span<EntityHandle> results, bool countOnly, uint16_t layerMask)
+	{
+		b2CircleShape circle;
+		circle.m_radius = radius;
+		return Overlap(circle, b2Transform((b2Vec2)center, b2Rot(0.0f)), results, countOnly, layerMask);
+	}
+
+	size_t QueryPolygon(std::span<const Vector2> points, std::span<EntityHandle> results, bool countOnly, uint16_t layerMask)
+	{
+		if (points.size() < 3 || points.size() > b2_maxPolygonVertices)
+		{
+			Debug::LogError("The number of points of an overlap polygon must be >= 3 and <= 8, the number of points given is " + std::to_string(points.size()));
+			return 0;
+		}
+
+		b2Vec2 vertices[b2_maxPolygonVertices];
+		for (size_t i = 0; i < points.size(); i++)
+		{
+			vertices[i] = (b2Vec2)points[i];
+		}
+
+		b2PolygonShape polygon;
+		polygon.Set(vertices, points.size());
+		return Overlap(polygon, b2Transform(b2Vec2_zero, b2Rot(0.0f)), results, countOnly, layerMask);
+	}
+
+	// Checks that every cast has at least one hit slot, and returns how many it has.
+	uint32_t GetSlotsPerCast(size_t castCount, size_t hitCount, size_t hitCountCount)
+	{
+		if (hitCountCount < castCount)
+		{
+			Debug::LogError("Not enough hit counts for a batched cast, there must be one per cast.");
+			return 0;
+		}
+
+		if (hitCount < castCount)
+		{
+			Debug::LogError("Not enough hits for a batched cast, there must be at least one per cast.");
+			return 0;
+		}
+
+		return castCount > 0 ? hitCount / castCount : 0;
+	}
+}
+
+void Physics::RaycastBatch(std::span<const Ray> rays, std::span<RaycastHit> hits, std::span<uint32_t> hitCounts,
+						   QueryMode mode, uint16_t layerMask)
+{
+	uint32_t slots = GetSlotsPerCast(rays.size(), hits.size(), hitCounts.size());
+	if (slots == 0)
+	{
+		return;
+	}
+
+	JobSystem::ParallelFor(rays.size(), QUERY_CHUNK_SIZE, [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			HitCollector collector(&hits[i * slots], slots, mode, layerMask);
+			RaycastCallback callback(collector);
+
+			b2Vec2 origin = (b2Vec2)rays[i].origin;
+			b2Vec2 target = origin + (b2Vec2)rays[i].direction;
+
+			// b2World::RayCast() only reads the broadphase, so it's safe from any number of threads.
+			if (b2DistanceSquared(origin, target) > 0.0f)
+			{
+				physicsWorld.RayCast(&callback, origin, target);
+			}
+
+			hitCounts[i] = collector.count;
+		}
+	});
+}
+
+void Physics::ShapeCastBatch(std::span<const ShapeCast> casts, std::span<RaycastHit> hits, std::span<uint32_t> hitCounts,
+							 QueryMode mode, uint16_t layerMask)
+{
+	uint32_t slots = GetSlotsPerCast(casts.size(), hits.size(), hitCounts.size());
+	if (slots == 0)
+	{
+		return;
+	}
+
+	const b2BroadPhase &broadPhase = physicsWorld.GetContactManager().m_broadPhase;
+
+	JobSystem::ParallelFor(casts.size(), QUERY_CHUNK_SIZE, [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			HitCollector collector(&hits[i * slots], slots, mode, layerMask);
+			ShapeCastCallback callback(collector, casts[i], broadPhase);
+
+			// The bounds of the shape at both ends of the cast cover everything it sweeps over.
+			b2AABB bounds;
+			bool empty = true;
+			for (int32 child = 0; child < casts[i].shape->GetChildCount(); child++)
+			{
+				b2AABB start;
+				casts[i].shape->ComputeAABB(&start, callback.castTransform, child);
+
+				b2AABB end = start;
+				end.lowerBound += (b2Vec2)casts[i].direction;
+				end.upperBound += (b2Vec2)casts[i].direction;
+
+				if (empty)
+				{
+					bounds = start;
+					empty = false;
+				}
+				else
+				{
+					bounds.Combine(start);
+				}
+				bounds.Combine(end);
+			}
+
+			if (!empty)
+			{
+				broadPhase.Query(&callback, bounds);
+			}
+
+			hitCounts[i] = collector.count;
+		}
+	});
+}
+
+size_t Physics::OverlapBox(Vector2 center, Vector2 size, float angle, std::span<EntityHandle> results, uint16_t layerMask)
+{
+	return QueryBox(center, size, angle, results, false, layerMask);
+}
+
+size_t Physics::OverlapCircle(Vector2 center, float radius, std::span<EntityHandle> results, uint16_t layerMask)
+{
+	return QueryCircle(center, radius, results, false, layerMask);
+}
+
+size_t Physics::OverlapPolygon(std::span<const Vector2> points, std::span<EntityHandle> results, uint16_t layerMask)
+{
+	return QueryPolygon(points, results, false, layerMask);
+}
+
+size_t Physics::CountOverlapBox(Vector2 center, Vector2 size, float angle, uint16_t layerMask)
+{
+	return QueryBox(center, size, angle, {}, true, layerMask);
+}
+
+size_t Physics::CountOverlapCircle(Vector2 center, float radius, uint16_t layerMask)
+{
+	return QueryCircle(center, radius, {}, true, layerMask);
+}
+
+size_t Physics::CountOverlapPolygon(std::span<const Vector2> points, uint16_t layerMask)
+{
+	return QueryPolygon(points, {}, true, layerMask);
+}
\ No newline at end of file
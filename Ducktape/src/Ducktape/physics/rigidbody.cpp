@@ -25,20 +25,43 @@ SOFTWARE.
 #include <Ducktape/physics/rigidbody.h>
 using namespace DT;
 
+namespace
+{
+    // Add a rigidbody to Physics::movableRigidbodies, or take it out with a swap and pop.
+    void SetMovable(Rigidbody2D *rb, bool movable)
+    {
+        std::vector<Rigidbody2D *> &movables = Physics::movableRigidbodies;
+        if (movable && rb->movableIndex == SIZE_MAX)
+        {
+            rb->movableIndex = movables.size();
+            movables.push_back(rb);
+        }
+        else if (!movable && rb->movableIndex != SIZE_MAX)
+        {
+            movables[rb->movableIndex] = movables.back();
+            movables[rb->movableIndex]->movableIndex = rb->movableIndex;
+            movables.pop_back();
+            rb->movableIndex = SIZE_MAX;
+        }
+    }
+}
+
 void Rigidbody2D::Constructor()
 {
     b2BodyDef bodyDef;
     bodyDef.userData.pointer = reinterpret_cast<uintptr_t>(entity);
 
     bodyDef.type = b2_dynamicBody;
+
+    // Bodies made during a batch join the broadphase when it ends, along with their colliders.
+    bodyDef.enabled = !Physics::IsBatching();
     body = Physics::physicsWorld.CreateBody(&bodyDef);
-}
+    SetMovable(this, true);
 
-void Rigidbody2D::Tick()
-{
-    entity->transform->SetPosition(Vector2(body->GetPosition().x, body->GetPosition().y));
-    entity->transform->SetRotation(body->GetAngle());
-    SetVelocity(Vector2(body->GetLinearVelocity().x, body->GetLinearVelocity().y) + Physics::globalGravity * GetGravityScale());
+    if (Physics::IsBatching())
+    {
+        Physics::batchedRigidbodies.push_back(this);
+    }
 }
 
 Vector2 Rigidbody2D::GetVelocity()
@@ -109,12 +132,12 @@ void Rigidbody2D::SetAngularDamping(float damping)
 
 float Rigidbody2D::GetGravityScale()
 {
-    return gravityScale;
+    return body->GetGravityScale();
 }
 
 void Rigidbody2D::SetGravityScale(float scale)
 {
-    gravityScale = scale;
+    body->SetGravityScale(scale);
 }
 
 BodyType Rigidbody2D::GetType()
@@ -145,6 +168,7 @@ void Rigidbody2D::SetType(BodyType type)
     {
         body->SetType(b2_dynamicBody);
     }
+    SetMovable(this, body->GetType() != b2_staticBody);
 }
 
 bool Rigidbody2D::GetContinous()
@@ -219,6 +243,44 @@ void Rigidbody2D::ApplyAngularImpulse(float impulse)
 
 void Rigidbody2D::OnDestroy()
 {
+    // Destroy the colliders and joints first, so that joints still get to destroy their b2Joint
+    // before the body (and every joint attached to it) is destroyed.
+    for (BehaviourScript *attachment : attachments)
+    {
+        if (!attachment->isDestroyed)
+        {
+            attachment->Destroy();
+        }
+    }
+    attachments.clear();
+
+    if (shapesDirty)
+    {
+        std::vector<Rigidbody2D *> &dirty = Physics::dirtyRigidbodies;
+        dirty.erase(std::remove(dirty.begin(), dirty.end(), this), dirty.end());
+    }
+
+    if (Physics::IsBatching())
+    {
+        std::vector<Rigidbody2D *> &batched = Physics::batchedRigidbodies;
+        batched.erase(std::remove(batched.begin(), batched.end(), this), batched.end());
+    }
+
+    SetMovable(this, false);
     Physics::physicsWorld.DestroyBody(body);
     body = nullptr;
+}
+
+void Rigidbody2D::Detach(BehaviourScript *attachment)
+{
+    attachments.erase(std::remove(attachments.begin(), attachments.end(), attachment), attachments.end());
+}
+
+void Rigidbody2D::MarkShapesDirty()
+{
+    if (!shapesDirty)
+    {
+        shapesDirty = true;
+        Physics::dirtyRigidbodies.push_back(this);
+    }
 }
\ No newline at end of file
@@ -39,14 +39,16 @@ void Camera::Constructor()
     }
 }
 
+#ifndef DT_HEADLESS
 void Camera::Tick()
 {
-    Vector2 pos = UnitToPixel(entity->transform->SetPosition());
+    Vector2 pos = UnitToPixel(entity->transform->GetInterpolatedPosition());
     Vector2 pos2 = Vector2(Application::Private::resolution.x / 4 + pos.x, Application::Private::resolution.y / 4 + pos.y);
 
     Application::view.setCenter(pos2.x, pos2.y);
-    Application::view.setRotation(entity->transform->GetRotation());
+    Application::view.setRotation(entity->transform->GetInterpolatedRotation() * Mathf::Rad2Deg);
 }
+#endif
 
 Vector2 Camera::UnitToPixel(Vector2 pos)
 {
@@ -58,18 +60,30 @@ Vector2 Camera::PixelToUnit(Vector2 pos)
     return Vector2(pos.x / (PIXEL_PER_UNIT / 2), pos.y / (PIXEL_PER_UNIT / 2));
 }
 
-Vector2 Camera::ScreenToWorldPos(Vector2 pos)
+Vector2 Camera::ScreenToWorldPos([[maybe_unused]] Vector2 pos)
 {
-    sf::Vector2f vec = Application::renderWindow.mapPixelToCoords(sf::Vector2i(pos.x, pos.y));
-    vec /= PIXEL_PER_UNIT;
-    vec -= sf::Vector2f(12.5f, 12.5f);
-    return Vector2(vec.x, vec.y);
+#ifndef DT_HEADLESS
+    if (Application::renderWindow != nullptr)
+    {
+        sf::Vector2f vec = Application::renderWindow->mapPixelToCoords(sf::Vector2i(pos.x, pos.y));
+        vec /= PIXEL_PER_UNIT;
+        vec -= sf::Vector2f(12.5f, 12.5f);
+        return Vector2(vec.x, vec.y);
+    }
+#endif
+    return Vector2(0, 0);
 }
 
-Vector2 Camera::WorldToScreenPos(Vector2 pos)
+Vector2 Camera::WorldToScreenPos([[maybe_unused]] Vector2 pos)
 {
-    sf::Vector2i vec = Application::renderWindow.mapCoordsToPixel(sf::Vector2f(pos.x * PIXEL_PER_UNIT, pos.y * PIXEL_PER_UNIT));
-    return Vector2(vec.x, vec.y);
+#ifndef DT_HEADLESS
+    if (Application::renderWindow != nullptr)
+    {
+        sf::Vector2i vec = Application::renderWindow->mapCoordsToPixel(sf::Vector2f(pos.x * PIXEL_PER_UNIT, pos.y * PIXEL_PER_UNIT));
+        return Vector2(vec.x, vec.y);
+    }
+#endif
+    return Vector2(0, 0);
 }
 
 const float Camera::PIXEL_PER_UNIT = 10.0f;
\ No newline at end of file
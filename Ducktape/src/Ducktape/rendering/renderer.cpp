@@ -25,6 +25,7 @@ SOFTWARE.
 #include <Ducktape/rendering/renderer.h>
 using namespace DT;
 
+#ifndef DT_HEADLESS
 std::vector<std::pair<std::string, sf::Texture>> Renderer::textureCache;
 
 int Renderer::LoadTextureFromCache(std::string path)
@@ -51,9 +52,16 @@ int Renderer::LoadTextureFromCache(std::string path)
     }
     return idx;
 }
+#endif
 
-void Renderer::DrawSprite(std::string path, Vector2 pos, float rot, Vector2 scl, int pixelPerUnit, Color color)
+void Renderer::DrawSprite([[maybe_unused]] std::string path, [[maybe_unused]] Vector2 pos, [[maybe_unused]] float rot, [[maybe_unused]] Vector2 scl, [[maybe_unused]] int pixelPerUnit, [[maybe_unused]] Color color)
 {
+#ifndef DT_HEADLESS
+    if (Application::renderWindow == nullptr)
+    {
+        return;
+    }
+
     int idx = LoadTextureFromCache(path);
     if (idx == -1)
     {
@@ -68,11 +76,12 @@ void Renderer::DrawSprite(std::string path, Vector2 pos, float rot, Vector2 scl,
     sf::Sprite sprite;
     sprite.setTexture(texture);
     sprite.setPosition((sf::Vector2f)pos);
-    sprite.setRotation(rot);
+    sprite.setRotation(rot * Mathf::Rad2Deg);
     sprite.setScale((sf::Vector2f)(scl / pixelPerUnit));
     sprite.setOrigin(sf::Vector2f(texture.getSize().x / 2, texture.getSize().y / 2));
 
     sprite.setColor((sf::Color)color);
 
-    Application::renderWindow.draw(sprite);
+    Application::renderWindow->draw(sprite);
+#endif
 }
\ No newline at end of file
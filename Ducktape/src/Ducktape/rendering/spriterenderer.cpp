@@ -58,10 +58,12 @@ std::string SpriteRenderer::GetSpritePath()
     return spritePath;
 }
 
+#ifndef DT_HEADLESS
 void SpriteRenderer::Tick()
 {
-    if (spritePath != "")
+    if (spritePath != "" && Application::renderWindow != nullptr)
     {
-        Renderer::DrawSprite(spritePath, Camera::WorldToScreenPos(entity->transform->SetPosition()), entity->transform->GetRotation(), entity->transform->GetScale(), pixelPerUnit, color);
+        Renderer::DrawSprite(spritePath, Camera::WorldToScreenPos(entity->transform->GetInterpolatedPosition()), entity->transform->GetInterpolatedRotation(), entity->transform->GetScale(), pixelPerUnit, color);
     }
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file
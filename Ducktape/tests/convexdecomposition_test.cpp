@@ -0,0 +1,121 @@
+/*
+MIT License
+
+Copyright (c) 2022 Ducktape
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+#include <cmath>
+#include <cstdio>
+
+#include <box2d/box2d.h>
+
+#include <Ducktape/physics/convexdecomposition.h>
+using namespace DT;
+
+namespace
+{
+    int failures = 0;
+
+    void Check(bool condition, const char *message)
+    {
+        if (!condition)
+        {
+            std::printf("FAILED: %s\n", message);
+            failures++;
+        }
+    }
+
+    float Area(const ConvexDecomposition::Pieces &pieces)
+    {
+        float area = 0.0f;
+        for (const std::vector<Vector2> &piece : pieces)
+        {
+            for (size_t i = 0, n = piece.size(); i < n; i++)
+            {
+                area += 0.5f * (piece[i].x * piece[(i + 1) % n].y - piece[(i + 1) % n].x * piece[i].y);
+            }
+        }
+        return area;
+    }
+
+    // Every piece must be accepted by Box2D without welding any of its points.
+    void CheckBox2DAccepts(const ConvexDecomposition::Pieces &pieces)
+    {
+        for (const std::vector<Vector2> &piece : pieces)
+        {
+            Check(piece.size() >= 3 && piece.size() <= b2_maxPolygonVertices, "piece has a valid number of points");
+
+            for (size_t i = 0; i < piece.size(); i++)
+            {
+                for (size_t j = i + 1; j < piece.size(); j++)
+                {
+                    b2Vec2 a(piece[i].x, piece[i].y);
+                    b2Vec2 b(piece[j].x, piece[j].y);
+                    Check(b2DistanceSquared(a, b) >= (0.5f * b2_linearSlop) * (0.5f * b2_linearSlop), "piece has no points Box2D would weld");
+                }
+            }
+
+            std::vector<b2Vec2> vertices;
+            for (const Vector2 &point : piece)
+            {
+                vertices.push_back(b2Vec2(point.x, point.y));
+            }
+
+            b2PolygonShape shape;
+            shape.Set(vertices.data(), vertices.size());
+            // A degenerate piece would become Box2D's fallback box, with a different area.
+            b2MassData massData;
+            shape.ComputeMass(&massData, 1.0f);
+            Check(std::abs(massData.mass - Area({piece})) < 1e-4f, "Box2D keeps the shape of the piece");
+        }
+    }
+
+    void ConcavePolygon()
+    {
+        std::vector<Vector2> points = {Vector2(0, 0), Vector2(4, 0), Vector2(4, 4), Vector2(3, 4), Vector2(3, 1), Vector2(1, 1), Vector2(1, 4), Vector2(0, 4)};
+        std::shared_ptr<const ConvexDecomposition::Pieces> pieces = ConvexDecomposition::Decompose(points);
+
+        Check(pieces->size() >= 3, "a U shape needs at least 3 convex pieces");
+        Check(std::abs(Area(*pieces) - 10.0f) < 1e-4f, "the pieces of a U shape cover its area");
+        CheckBox2DAccepts(*pieces);
+    }
+
+    void ThinSpike()
+    {
+        std::vector<Vector2> points = {Vector2(0, 0), Vector2(10, 0), Vector2(10, 1), Vector2(5.001f, 1), Vector2(5, 10), Vector2(4.999f, 1), Vector2(0, 1)};
+        std::shared_ptr<const ConvexDecomposition::Pieces> pieces = ConvexDecomposition::Decompose(points);
+
+        Check(!pieces->empty(), "a box with a thin spike still decomposes");
+        Check(std::abs(Area(*pieces) - 10.0f) < 0.02f, "the spike is dropped and the box is kept");
+        CheckBox2DAccepts(*pieces);
+    }
+}
+
+int main()
+{
+    ConcavePolygon();
+    ThinSpike();
+
+    if (failures == 0)
+    {
+        std::printf("All convex decomposition tests passed.\n");
+    }
+    return failures == 0 ? 0 : 1;
+}
\ No newline at end of file